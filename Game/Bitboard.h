@@ -0,0 +1,701 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Zobrist.h"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+using namespace std;
+
+// Битовое представление доски: 32 тёмные клетки, клетка (x, y) имеет номер 4 * x + y / 2
+typedef uint32_t MASK_T;
+
+const MASK_T EVEN_ROWS = 0x0F0F0F0F; // строки 0, 2, 4, 6 (тёмные клетки в столбцах 1, 3, 5, 7)
+const MASK_T ODD_ROWS = 0xF0F0F0F0;  // строки 1, 3, 5, 7 (тёмные клетки в столбцах 0, 2, 4, 6)
+const MASK_T LEFT_EDGE = 0x11111111;  // первая клетка каждой строки
+const MASK_T RIGHT_EDGE = 0x88888888; // последняя клетка каждой строки
+const MASK_T PROMOTE_ROW[2] = {0x0000000F, 0xF0000000}; // строки превращения в дамку для белых и чёрных
+
+// Направления по диагоналям: 0 - вверх-влево, 1 - вверх-вправо, 2 - вниз-влево, 3 - вниз-вправо
+// Противоположное направление к dir - это 3 - dir
+const int MAN_DIRS[2][2] = {{0, 1}, {2, 3}}; // куда ходят простые шашки белых и чёрных
+
+inline int pop_count(const MASK_T b)
+{
+#ifdef _MSC_VER
+    return __popcnt(b);
+#else
+    return __builtin_popcount(b);
+#endif
+}
+
+// номер младшего установленного бита (b != 0)
+inline int low_bit(const MASK_T b)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, b);
+    return int(idx);
+#else
+    return __builtin_ctz(b);
+#endif
+}
+
+// номер старшего установленного бита (b != 0)
+inline int high_bit(const MASK_T b)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse(&idx, b);
+    return int(idx);
+#else
+    return 31 - __builtin_clz(b);
+#endif
+}
+
+inline MASK_T sq_mask(const int sq)
+{
+    return MASK_T(1) << sq;
+}
+
+inline POS_T sq_x(const int sq)
+{
+    return POS_T(sq / 4);
+}
+
+inline POS_T sq_y(const int sq)
+{
+    return POS_T(2 * (sq % 4) + (sq / 4 % 2 == 0));
+}
+
+// номер клетки по координатам, -1 для светлых клеток
+inline int square(const POS_T x, const POS_T y)
+{
+    if ((x + y) % 2 == 0)
+        return -1;
+    return 4 * x + y / 2;
+}
+
+// сдвигает все фигуры маски на одну клетку по диагонали dir, вышедшие за доску пропадают
+inline MASK_T shift(const MASK_T b, const int dir)
+{
+    switch (dir)
+    {
+    case 0:
+        return ((b & EVEN_ROWS) >> 4) | ((b & ODD_ROWS & ~LEFT_EDGE) >> 5);
+    case 1:
+        return ((b & EVEN_ROWS & ~RIGHT_EDGE) >> 3) | ((b & ODD_ROWS) >> 4);
+    case 2:
+        return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_EDGE) << 3);
+    default:
+        return ((b & EVEN_ROWS & ~RIGHT_EDGE) << 5) | ((b & ODD_ROWS) << 4);
+    }
+}
+
+// Лучи дамки: ray[sq][dir] - все клетки от sq (не включая её) до края доски по диагонали dir.
+// Таблица считается при компиляции
+struct ray_table
+{
+    MASK_T ray[32][4];
+};
+
+constexpr ray_table make_rays()
+{
+    ray_table t{};
+    const int dx[4] = {-1, -1, 1, 1}, dy[4] = {-1, 1, -1, 1};
+    for (int sq = 0; sq < 32; ++sq)
+    {
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            int x = sq / 4 + dx[dir], y = 2 * (sq % 4) + (sq / 4 % 2 == 0) + dy[dir];
+            for (; x >= 0 && x < 8 && y >= 0 && y < 8; x += dx[dir], y += dy[dir])
+                t.ray[sq][dir] |= MASK_T(1) << (4 * x + y / 2);
+        }
+    }
+    return t;
+}
+
+constexpr ray_table RAYS = make_rays();
+
+// первая фигура из occ на луче dir (occ - клетки этого луча, не пустая маска): вниз номера клеток растут, вверх убывают
+inline int first_on_ray(const MASK_T occ, const int dir)
+{
+    return (dir >= 2 ? low_bit(occ) : high_bit(occ));
+}
+
+// клетки, которые дамка на sq видит по диагонали dir: пустые до первой фигуры и сама эта фигура
+inline MASK_T ray_attacks(const int sq, const int dir, const MASK_T occ)
+{
+    const MASK_T ray = RAYS.ray[sq][dir];
+    const MASK_T blockers = ray & occ;
+    if (!blockers)
+        return ray;
+    const int first = first_on_ray(blockers, dir);
+    return ray ^ RAYS.ray[first][dir];
+}
+
+// на сколько строк простая шашка цвета color на клетке sq ушла от своего края (белые идут к строке 0)
+inline int advance_of(const bool color, const int sq)
+{
+    return color ? sq / 4 : 7 - sq / 4;
+}
+
+// Ход на битовой доске: откуда, куда и побитые клетки. Поиск ходит целыми сериями взятий: составной ход
+// хранит все побитые фигуры и превращение в дамку по дороге. Человек ходит по одному прыжку серии -
+// это ход с одной побитой клеткой. Конструктор по умолчанию ничего не заполняет, чтобы списки ходов
+// на стеке не стоили ничего
+struct bit_move
+{
+    int8_t from, to;
+    bool promote; // шашка стала дамкой за время хода (для серий, закончившихся не на последней строке)
+    MASK_T caps;  // побитые клетки (0 - тихий ход)
+
+    bit_move() = default;
+    bit_move(const int from, const int to, const int cap = -1)
+        : from(int8_t(from)), to(int8_t(to)), promote(false), caps(cap == -1 ? 0 : sq_mask(cap))
+    {
+    }
+    bit_move(const int from, const int to, const MASK_T caps, const bool promote)
+        : from(int8_t(from)), to(int8_t(to)), promote(promote), caps(caps)
+    {
+    }
+    explicit bit_move(const move_pos &turn)
+        : bit_move(square(turn.x, turn.y), square(turn.x2, turn.y2), turn.xb == -1 ? -1 : square(turn.xb, turn.yb))
+    {
+    }
+
+    bool operator==(const bit_move &other) const
+    {
+        return from == other.from && to == other.to && caps == other.caps && promote == other.promote;
+    }
+    bool operator!=(const bit_move &other) const
+    {
+        return !(*this == other);
+    }
+
+    // ход в координатах доски; только для тихого хода или одного прыжка
+    move_pos to_move_pos() const
+    {
+        if (!caps)
+            return move_pos(sq_x(from), sq_y(from), sq_x(to), sq_y(to));
+        const int cap = low_bit(caps);
+        return move_pos(sq_x(from), sq_y(from), sq_x(to), sq_y(to), sq_x(cap), sq_y(cap));
+    }
+};
+
+// Ёмкость списка ходов: тихих ходов не больше 12 * 13 (дамка на большой диагонали), составных взятий
+// на практике много меньше; если их всё же больше, лишние серии не попадают в список
+const int MAX_TURNS = 256;
+
+// Список ходов фиксированной ёмкости: живёт на стеке узла поиска, поэтому генерация ходов не трогает кучу
+class move_list
+{
+  public:
+    void clear()
+    {
+        count = 0;
+    }
+    void push_back(const bit_move turn)
+    {
+        turns[count++] = turn;
+    }
+    void pop_back()
+    {
+        --count;
+    }
+    bool full() const
+    {
+        return count == MAX_TURNS;
+    }
+    template <class... Args> void emplace_back(Args... args)
+    {
+        turns[count++] = bit_move(args...);
+    }
+    size_t size() const
+    {
+        return count;
+    }
+    bool empty() const
+    {
+        return count == 0;
+    }
+    bit_move &operator[](const size_t idx)
+    {
+        return turns[idx];
+    }
+    const bit_move &operator[](const size_t idx) const
+    {
+        return turns[idx];
+    }
+    bit_move *begin()
+    {
+        return turns;
+    }
+    bit_move *end()
+    {
+        return turns + count;
+    }
+    const bit_move *begin() const
+    {
+        return turns;
+    }
+    const bit_move *end() const
+    {
+        return turns + count;
+    }
+    bool operator==(const move_list &other) const
+    {
+        return count == other.count && equal(begin(), end(), other.begin());
+    }
+
+  private:
+    bit_move turns[MAX_TURNS];
+    size_t count = 0;
+};
+
+struct Position
+{
+    MASK_T pieces[2] = {0, 0}; // фигуры белых (0) и чёрных (1), как цвет в Logic
+    MASK_T kings = 0;          // дамки обоих цветов
+    uint64_t key = 0;          // хеш Зобриста расстановки фигур, обновляется в make_move / unmake_move
+    // слагаемые оценки, тоже обновляются в make_move / unmake_move: число простых шашек и дамок каждого цвета
+    // и суммарное продвижение простых шашек
+    int8_t men_count[2] = {0, 0};
+    int8_t king_count[2] = {0, 0};
+    int16_t advance[2] = {0, 0};
+
+    Position() = default;
+
+    // 1 - white, 2 - black, 3 - white queen, 4 - black queen
+    explicit Position(const vector<vector<POS_T>> &mtx)
+    {
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            const POS_T type = mtx[sq_x(sq)][sq_y(sq)];
+            if (!type)
+                continue;
+            pieces[1 - type % 2] |= sq_mask(sq);
+            if (type > 2)
+                kings |= sq_mask(sq);
+            key ^= ZOBRIST.piece[type - 1][sq];
+        }
+        count_material();
+    }
+
+    // пересчитывает ключ Зобриста по маскам фигур, когда позиция собрана не ходами
+    void compute_key()
+    {
+        key = 0;
+        for (int color = 0; color < 2; ++color)
+            for (MASK_T m = pieces[color]; m; m &= m - 1)
+                key ^= ZOBRIST.piece[color + 2 * ((kings & (m & -m)) != 0)][low_bit(m)];
+    }
+
+    // пересчитывает слагаемые оценки по маскам фигур, когда позиция собрана не ходами
+    void count_material()
+    {
+        for (int color = 0; color < 2; ++color)
+        {
+            men_count[color] = int8_t(pop_count(men(color)));
+            king_count[color] = int8_t(pop_count(queens(color)));
+            advance[color] = 0;
+            for (MASK_T m = men(color); m; m &= m - 1)
+                advance[color] += int16_t(advance_of(color, low_bit(m)));
+        }
+    }
+
+    MASK_T occupied() const
+    {
+        return pieces[0] | pieces[1];
+    }
+
+    MASK_T empty() const
+    {
+        return ~occupied();
+    }
+
+    MASK_T men(const bool color) const
+    {
+        return pieces[color] & ~kings;
+    }
+
+    MASK_T queens(const bool color) const
+    {
+        return pieces[color] & kings;
+    }
+
+    // ключ позиции вместе с цветом ходящего
+    uint64_t hash(const bool color) const
+    {
+        return key ^ (color ? ZOBRIST.side : 0);
+    }
+
+    bool operator==(const Position &other) const
+    {
+        return pieces[0] == other.pieces[0] && pieces[1] == other.pieces[1] && kings == other.kings;
+    }
+};
+
+// начальная расстановка: чёрные на строках 0 - 2, белые на строках 5 - 7
+inline Position start_position()
+{
+    Position pos;
+    pos.pieces[1] = 0x00000FFF;
+    pos.pieces[0] = 0xFFF00000;
+    for (int sq = 0; sq < 12; ++sq)
+        pos.key ^= ZOBRIST.piece[1][sq] ^ ZOBRIST.piece[0][31 - sq];
+    pos.count_material();
+    return pos;
+}
+
+// Генерация ходов. Все функции дописывают ходы в res
+
+// Прыжки - по одному взятию за раз, так ходит человек, и так собираются серии для показа хода бота
+
+// прыжки простыми шашками из маски men: для каждого направления сдвиг на врага и затем на пустую клетку
+inline void add_men_beats(const Position &pos, const MASK_T men, const bool color, move_list &res)
+{
+    const MASK_T enemy = pos.pieces[!color], empty = pos.empty();
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        for (MASK_T to = shift(shift(men, dir) & enemy, dir) & empty; to; to &= to - 1)
+        {
+            const MASK_T cap = shift(to & -to, 3 - dir);
+            res.emplace_back(low_bit(shift(cap, 3 - dir)), low_bit(to), low_bit(cap));
+        }
+    }
+}
+
+// тихие ходы простыми шашками из маски men
+inline void add_men_moves(const Position &pos, const MASK_T men, const bool color, move_list &res)
+{
+    const MASK_T empty = pos.empty();
+    for (const int dir : MAN_DIRS[color])
+    {
+        for (MASK_T to = shift(men, dir) & empty; to; to &= to - 1)
+        {
+            res.emplace_back(low_bit(shift(to & -to, 3 - dir)), low_bit(to));
+        }
+    }
+}
+
+// прыжки дамкой с клетки sq: по каждой диагонали до первой фигуры, если это враг - все пустые клетки за ней
+inline void add_queen_beats(const Position &pos, const int sq, const bool color, move_list &res)
+{
+    const MASK_T occ = pos.occupied();
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        const MASK_T seen = ray_attacks(sq, dir, occ) & pos.pieces[!color];
+        if (!seen)
+            continue;
+        const int cap = low_bit(seen);
+        for (MASK_T land = ray_attacks(cap, dir, occ) & ~occ; land;) // от ближней к дальней клетке
+        {
+            const int to = first_on_ray(land, dir);
+            land ^= sq_mask(to);
+            res.emplace_back(sq, to, cap);
+        }
+    }
+}
+
+// тихие ходы дамкой с клетки sq
+inline void add_queen_moves(const Position &pos, const int sq, move_list &res)
+{
+    const MASK_T occ = pos.occupied();
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        for (MASK_T free = ray_attacks(sq, dir, occ) & ~occ; free;)
+        {
+            const int to = first_on_ray(free, dir);
+            free ^= sq_mask(to);
+            res.emplace_back(sq, to);
+        }
+    }
+}
+
+// только прыжки фигурой с клетки sq
+inline void gen_hop_beats(const Position &pos, const int sq, move_list &res)
+{
+    res.clear();
+    const bool color = (pos.pieces[1] & sq_mask(sq)) != 0;
+    if (pos.kings & sq_mask(sq))
+        add_queen_beats(pos, sq, color, res);
+    else
+        add_men_beats(pos, sq_mask(sq), color, res);
+}
+
+// первые прыжки или тихие ходы цвета color; если есть взятия, то только они. Возвращает, являются ли ходы взятиями
+inline bool gen_hops(const Position &pos, const bool color, move_list &res)
+{
+    res.clear();
+    add_men_beats(pos, pos.men(color), color, res);
+    for (MASK_T q = pos.queens(color); q; q &= q - 1)
+        add_queen_beats(pos, low_bit(q), color, res);
+    if (!res.empty())
+        return true;
+    add_men_moves(pos, pos.men(color), color, res);
+    for (MASK_T q = pos.queens(color); q; q &= q - 1)
+        add_queen_moves(pos, low_bit(q), res);
+    return false;
+}
+
+// прыжки или тихие ходы фигуры с клетки sq; если есть взятия, то только они. Возвращает, являются ли ходы взятиями
+inline bool gen_hops(const Position &pos, const int sq, move_list &res)
+{
+    gen_hop_beats(pos, sq, res);
+    if (!res.empty())
+        return true;
+    if (pos.kings & sq_mask(sq))
+        add_queen_moves(pos, sq, res);
+    else
+        add_men_moves(pos, sq_mask(sq), (pos.pieces[1] & sq_mask(sq)) != 0, res);
+    return false;
+}
+
+// Составные ходы поиска: серия взятий целиком за один проход генератора
+
+// есть ли у цвета color хоть одно взятие, без генерации ходов
+inline bool has_beats(const Position &pos, const bool color)
+{
+    const MASK_T occ = pos.occupied(), enemy = pos.pieces[!color], empty = ~occ;
+    const MASK_T men = pos.men(color);
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        if (shift(shift(men, dir) & enemy, dir) & empty)
+            return true;
+    }
+    for (MASK_T q = pos.queens(color); q; q &= q - 1)
+    {
+        const int sq = low_bit(q);
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const MASK_T seen = ray_attacks(sq, dir, occ) & enemy;
+            if (seen && (shift(seen, dir) & empty))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Продолжает серию фигуры, которая начала ход на from и стоит на sq. Серия идёт по маскам, без изменения позиции:
+// побитые фигуры сразу убираются из occ и enemy, сама фигура в occ не входит. Каждая законченная серия -
+// один составной ход; серии с тем же итогом (куда, кого побили, стала ли дамкой) добавляются один раз
+inline void add_series(const MASK_T occ, const MASK_T enemy, const int from, const int sq, const bool queen,
+                       const bool promoted, const MASK_T caps, const bool color, move_list &res)
+{
+    bool extended = false;
+    for (int dir = 0; dir < 4; ++dir)
+    {
+        if (queen)
+        {
+            const MASK_T seen = ray_attacks(sq, dir, occ) & enemy;
+            if (!seen)
+                continue;
+            for (MASK_T land = ray_attacks(low_bit(seen), dir, occ) & ~occ; land;)
+            {
+                const int to = first_on_ray(land, dir);
+                land ^= sq_mask(to);
+                extended = true;
+                add_series(occ & ~seen, enemy & ~seen, from, to, true, promoted, caps | seen, color, res);
+            }
+        }
+        else
+        {
+            const MASK_T over = shift(sq_mask(sq), dir) & enemy;
+            const MASK_T land = shift(over, dir) & ~occ;
+            if (!land)
+                continue;
+            extended = true;
+            const bool crowned = (land & PROMOTE_ROW[color]) != 0; // дальше серия продолжается дамкой
+            add_series(occ & ~over, enemy & ~over, from, low_bit(land), crowned, promoted || crowned, caps | over,
+                       color, res);
+        }
+    }
+    if (extended || !caps)
+        return;
+    const bit_move turn(from, sq, caps, promoted);
+    if (res.full() || find(res.begin(), res.end(), turn) != res.end())
+        return;
+    res.push_back(turn);
+}
+
+// только взятия цвета color, каждая серия - один ход
+inline void gen_beats(const Position &pos, const bool color, move_list &res)
+{
+    res.clear();
+    const MASK_T occ = pos.occupied();
+    for (MASK_T m = pos.pieces[color]; m; m &= m - 1)
+    {
+        const int sq = low_bit(m);
+        add_series(occ & ~sq_mask(sq), pos.pieces[!color], sq, sq, (pos.kings & sq_mask(sq)) != 0, false, 0, color,
+                   res);
+    }
+}
+
+// все ходы цвета color; если есть взятия, то только они (серии целиком). Возвращает, являются ли ходы взятиями
+inline bool gen_turns(const Position &pos, const bool color, move_list &res)
+{
+    if (has_beats(pos, color))
+    {
+        gen_beats(pos, color, res);
+        return true;
+    }
+    res.clear();
+    add_men_moves(pos, pos.men(color), color, res);
+    for (MASK_T q = pos.queens(color); q; q &= q - 1)
+        add_queen_moves(pos, low_bit(q), res);
+    return false;
+}
+
+// Запись для отмены хода: побитые дамки и превращение в дамку
+struct undo_rec
+{
+    MASK_T cap_kings = 0;  // какие из побитых фигур были дамками
+    bool promoted = false; // ходившая шашка стала дамкой
+};
+
+// убирает (или возвращает) фигуру цвета color с клетки sq в ключе и слагаемых оценки; sign = -1 - убрать
+inline void count_piece(Position &pos, const bool color, const int sq, const bool queen, const int sign)
+{
+    pos.key ^= ZOBRIST.piece[color + 2 * queen][sq];
+    if (queen)
+        pos.king_count[color] += int8_t(sign);
+    else
+    {
+        pos.men_count[color] += int8_t(sign);
+        pos.advance[color] += int16_t(sign * advance_of(color, sq));
+    }
+}
+
+// производит ход (тихий, прыжок или целую серию) на месте, запоминая в undo всё, что нужно для его отмены.
+// Серия может закончиться на той же клетке, с которой началась
+inline void make_move(Position &pos, const bit_move turn, undo_rec &undo)
+{
+    const MASK_T from = sq_mask(turn.from), to = sq_mask(turn.to);
+    const bool color = (pos.pieces[1] & from) != 0;
+    undo.cap_kings = pos.kings & turn.caps;
+    if (turn.caps)
+    {
+        pos.pieces[!color] &= ~turn.caps;
+        pos.kings &= ~turn.caps;
+        for (MASK_T m = turn.caps; m; m &= m - 1)
+            count_piece(pos, !color, low_bit(m), (undo.cap_kings & (m & -m)) != 0, -1);
+    }
+    const bool is_queen = (pos.kings & from) != 0;
+    undo.promoted = !is_queen && (turn.promote || (PROMOTE_ROW[color] & to));
+    pos.pieces[color] = (pos.pieces[color] & ~from) | to;
+    if (is_queen || undo.promoted)
+        pos.kings = (pos.kings & ~from) | to;
+    count_piece(pos, color, turn.from, is_queen, -1);
+    count_piece(pos, color, turn.to, is_queen || undo.promoted, 1);
+}
+
+// отменяет ход, сделанный make_move
+inline void unmake_move(Position &pos, const bit_move turn, const undo_rec &undo)
+{
+    const MASK_T from = sq_mask(turn.from), to = sq_mask(turn.to);
+    const bool color = (pos.pieces[1] & to) != 0;
+    const bool is_queen = (pos.kings & to) != 0;
+    const bool was_queen = is_queen && !undo.promoted;
+    count_piece(pos, color, turn.to, is_queen, -1);
+    count_piece(pos, color, turn.from, was_queen, 1);
+    pos.pieces[color] = (pos.pieces[color] & ~to) | from;
+    if (is_queen)
+        pos.kings = (pos.kings & ~to) | (was_queen ? from : 0);
+    if (turn.caps)
+    {
+        pos.pieces[!color] |= turn.caps;
+        pos.kings |= undo.cap_kings;
+        for (MASK_T m = turn.caps; m; m &= m - 1)
+            count_piece(pos, !color, low_bit(m), (undo.cap_kings & (m & -m)) != 0, 1);
+    }
+}
+
+// производит ход на копии позиции
+inline Position make_turn(Position pos, const bit_move turn)
+{
+    undo_rec undo;
+    make_move(pos, turn, undo);
+    return pos;
+}
+
+// ищет прыжки, из которых состоит составной ход turn: путь фигуры с клетки sq, на котором побиты ровно turn.caps
+inline bool find_hops(Position &pos, const int sq, const bit_move turn, const bool promoted, move_list &hops)
+{
+    const size_t total = size_t(pop_count(turn.caps));
+    if (hops.size() == total)
+        return sq == turn.to && promoted == turn.promote;
+    move_list beats;
+    gen_hop_beats(pos, sq, beats);
+    for (auto hop : beats)
+    {
+        if (!(hop.caps & turn.caps))
+            continue;
+        undo_rec undo;
+        make_move(pos, hop, undo);
+        hops.push_back(hop);
+        const bool found = find_hops(pos, hop.to, turn, promoted || undo.promoted, hops);
+        unmake_move(pos, hop, undo);
+        if (found)
+            return true;
+        hops.pop_back();
+    }
+    return false;
+}
+
+// составной ход как последовательность прыжков (тихий ход - он сам), чтобы показать его на доске
+inline move_list turn_hops(Position pos, const bit_move turn)
+{
+    move_list hops;
+    if (!turn.caps)
+        hops.push_back(turn);
+    else
+        find_hops(pos, turn.from, turn, false, hops);
+    return hops;
+}
+
+// продолжения серии взятий фигурой с клетки sq до её конца: f вызывается для каждой позиции после серии
+template <class F> void for_each_series_end(Position &pos, const int sq, vector<bit_move> &series, F &f)
+{
+    move_list beats;
+    gen_hop_beats(pos, sq, beats);
+    if (beats.empty())
+    {
+        f(const_cast<const Position &>(pos), const_cast<const vector<bit_move> &>(series));
+        return;
+    }
+    for (auto turn : beats)
+    {
+        undo_rec undo;
+        make_move(pos, turn, undo);
+        series.push_back(turn);
+        for_each_series_end(pos, turn.to, series, f);
+        series.pop_back();
+        unmake_move(pos, turn, undo);
+    }
+}
+
+// Все ходы цвета color целиком (серия взятий - один ход): f(позиция после хода, ходы серии) вызывается
+// для каждого хода. Позиция меняется на время перебора и возвращается в исходную
+template <class F> void for_each_full_turn(Position &pos, const bool color, F &&f)
+{
+    move_list turns;
+    vector<bit_move> series;
+    const bool have_beats = gen_hops(pos, color, turns);
+    for (auto turn : turns)
+    {
+        undo_rec undo;
+        make_move(pos, turn, undo);
+        series.assign(1, turn);
+        if (have_beats)
+            for_each_series_end(pos, turn.to, series, f);
+        else
+            f(const_cast<const Position &>(pos), const_cast<const vector<bit_move> &>(series));
+        unmake_move(pos, turn, undo);
+    }
+}
@@ -5,6 +5,7 @@
 
 #include "../Models/Move.h"
 #include "../Models/Project_path.h"
+#include "Logger.h"
 
 #ifdef __APPLE__
     #include <SDL2/SDL.h>
@@ -213,6 +214,12 @@ public:
         rerender();
     }
 
+    // Перерисовка кадра без изменений, пока идёт поиск бота
+    void render_frame()
+    {
+        rerender();
+    }
+
     // Изменение размера окна
     void reset_window_size()
     {
@@ -357,9 +364,7 @@ private:
     }
 
     void print_exception(const string& text) {
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Error: " << text << ". "<< SDL_GetError() << endl;
-        fout.close();
+        game_log().write(LogLevel::ERR, log_fields(), text + ". " + SDL_GetError());
     }
 
   public:
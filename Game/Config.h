@@ -31,6 +31,12 @@ class Config
         return config[setting_dir][setting_name];
     }
 
+    // Меняет настройку только в памяти (settings.json не перезаписывается), нужно утилитам без окна
+    void set(const string &setting_dir, const string &setting_name, const json &value)
+    {
+        config[setting_dir][setting_name] = value;
+    }
+
   private:
     json config;
 };
@@ -0,0 +1,60 @@
+#pragma once
+#include <fstream>
+#include <string>
+
+#include "Bitboard.h"
+#include "Config.h"
+
+using namespace std;
+
+// Веса оценки в сотых долях шашки: простая шашка, дамка в режимах NumberOnly и NumberAndPotential, строка
+// продвижения шашки. Значения по умолчанию подобраны вручную, Tools/tune подбирает их по партиям бота
+struct eval_weights
+{
+    int man = 100;
+    int queen = 400;
+    int potential_queen = 500;
+    int advance = 5;
+};
+
+// читает веса из JSON файла; нет файла или веса - остаётся значение по умолчанию
+inline eval_weights load_eval_weights(const string &path)
+{
+    eval_weights weights;
+    ifstream fin(path);
+    if (!fin)
+        return weights;
+    const json data = json::parse(fin, nullptr, false);
+    if (!data.is_object())
+        return weights;
+    weights.man = data.value("Man", weights.man);
+    weights.queen = data.value("Queen", weights.queen);
+    weights.potential_queen = data.value("PotentialQueen", weights.potential_queen);
+    weights.advance = data.value("Advance", weights.advance);
+    return weights;
+}
+
+inline bool save_eval_weights(const string &path, const eval_weights &weights)
+{
+    ofstream fout(path, ios_base::trunc);
+    json data;
+    data["Man"] = weights.man;
+    data["Queen"] = weights.queen;
+    data["PotentialQueen"] = weights.potential_queen;
+    data["Advance"] = weights.advance;
+    fout << data.dump(4) << "\n";
+    return bool(fout);
+}
+
+// Материал и продвижение с точки зрения цвета color в сотых долях шашки (Logic::calc_score без проверки конца
+// партии): Potential - режим NumberAndPotential, иначе NumberOnly
+template <bool Potential> int material_score(const Position &pos, const bool color, const eval_weights &weights)
+{
+    int score = weights.man * (pos.men_count[color] - pos.men_count[!color]);
+    const int king_diff = pos.king_count[color] - pos.king_count[!color];
+    if (Potential)
+        score += weights.potential_queen * king_diff + weights.advance * (pos.advance[color] - pos.advance[!color]);
+    else
+        score += weights.queen * king_diff;
+    return score;
+}
@@ -1,20 +1,22 @@
 #pragma once
 #include <chrono>
+#include <future>
+#include <sstream>
 #include <thread>
 
 #include "../Models/Project_path.h"
 #include "Board.h"
 #include "Config.h"
 #include "Hand.h"
+#include "Logger.h"
 #include "Logic.h"
 
 class Game
 {
   public:
-    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&board, &config)
+    Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&config)
     {
-        ofstream fout(project_path + "log.txt", ios_base::trunc);
-        fout.close();
+        game_log().set_level(log_level_from_name(config("Game", "LogLevel"))); // лог открывается и очищается здесь
     }
 
     // Возвращает результат игры: 0 - выход, 1 - победа чёрного, 2 - победа белого, или ничья
@@ -22,10 +24,11 @@ class Game
     {
         // Фиксируем начальное время для измерения длительности игры
         auto start = chrono::steady_clock::now();
+        game_id = game_log().new_game();
         if (is_replay)
         {
             // Сброс настроек при новой игре
-            logic = Logic(&board, &config);
+            logic = Logic(&config);
             config.reload();
             board.redraw();
         }
@@ -42,7 +45,7 @@ class Game
         while (++turn_num < Max_turns) // Ход:
         {
             beat_series = 0;
-            logic.find_turns(turn_num % 2);
+            logic.find_turns(turn_num % 2, board.get_board());
 
             // Если ходов нет, игра завершена
             if (logic.turns.empty())
@@ -54,8 +57,13 @@ class Game
             // Проверяем, является ли текущий игрок ботом
             if (!config("Bot", string("Is") + string((turn_num % 2) ? "Black" : "White") + string("Bot")))
             {
+                // Если следующим ходит бот, он думает над ответом, пока ходит человек
+                const string bot_side = ((1 - turn_num % 2) ? "Black" : "White");
+                if (config("Bot", "BotPonder") && config("Bot", "Is" + bot_side + "Bot"))
+                    logic.start_ponder(Position(board.get_board()), turn_num % 2, config("Bot", bot_side + "BotLevel"));
                 // Если игрок человек, выполняем его ход
                 auto resp = player_turn(turn_num % 2);
+                logic.stop_ponder(); // в том числе при выходе, отмене хода и новой игре
                 if (resp == Response::QUIT) // Нажатие на выход
                 {
                     is_quit = true;
@@ -83,14 +91,32 @@ class Game
                 }
             }
             else
-                bot_turn(turn_num % 2); // ход бота
+            {
+                auto resp = bot_turn(turn_num % 2, turn_num + 1); // ход бота
+                if (resp == Response::QUIT)
+                {
+                    is_quit = true;
+                    break;
+                }
+                else if (resp == Response::REPLAY)
+                {
+                    is_replay = true;
+                    break;
+                }
+                else if (resp == Response::BACK) // отмена во время поиска: снова ходит предыдущий игрок
+                {
+                    board.rollback();
+                    turn_num -= 2;
+                }
+            }
         }
         auto end = chrono::steady_clock::now(); // запись времени окончания хода
 
-        // Запись хода в лог файл:
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Game time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-        fout.close();
+        // Запись времени партии в лог
+        log_fields fields;
+        fields.game = game_id;
+        fields.time_ms = (int)chrono::duration<double, milli>(end - start).count();
+        game_log().write(LogLevel::INFO, fields, "Game time");
 
         // Перезапуск игры
         if (is_replay)
@@ -122,23 +148,45 @@ class Game
 
   private:
 
-    // Ход бота
-    void bot_turn(const bool color)
+    // Ход бота. Поиск идёт в отдельном потоке, а окно тем временем обрабатывает события и перерисовывается.
+    // Возвращает Response::QUIT, Response::REPLAY или Response::BACK, если их нажали во время поиска
+    // (поиск тогда отменяется и ход не делается), иначе Response::OK
+    Response bot_turn(const bool color, const int move_num)
     {
         auto start = chrono::steady_clock::now(); // Начало хода
 
-        auto delay_ms = config("Bot", "BotDelayMS"); // Задержка перед ходом бота (Берется из конфига с настройками)
-        // new thread for equal delay for each turn
-        thread th(SDL_Delay, delay_ms);
-        auto turns = logic.find_best_turns(color); // Поиск хода
-        th.join();
+        const size_t delay_ms = config("Bot", "BotDelayMS"); // Время на ход бота (Берется из конфига с настройками)
+        cancel_token token;
+        auto search = logic.find_best_turns_async(Position(board.get_board()), color, token); // Поиск хода
+        auto search_end = start; // Конец поиска
+        bool searching = true;
+        // ход показывается не раньше, чем через delay_ms, поиск сам останавливается, когда это время кончается
+        while (searching || chrono::steady_clock::now() - start < chrono::milliseconds(delay_ms))
+        {
+            if (searching && search.wait_for(chrono::milliseconds(FRAME_MS)) == future_status::ready)
+            {
+                searching = false;
+                search_end = chrono::steady_clock::now();
+            }
+            else if (!searching)
+                SDL_Delay(FRAME_MS);
+            auto resp = hand.poll();
+            if (resp != Response::OK)
+            {
+                token.cancel();
+                search.wait();
+                return resp;
+            }
+            board.render_frame();
+        }
+        auto turns = search.get();
         bool is_first = true;
         // making moves
         for (auto turn : turns)
         {
             if (!is_first)
             {
-                SDL_Delay(delay_ms);  // Задержка
+                SDL_Delay(Uint32(delay_ms));  // Задержка
             }
             is_first = false;
             beat_series += (turn.xb != -1);
@@ -147,10 +195,45 @@ class Game
 
         auto end = chrono::steady_clock::now(); // Время конца хода
 
-        // Запись в лог хода
-        ofstream fout(project_path + "log.txt", ios_base::app); 
-        fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-        fout.close(); // Закрытие файла с логами
+        // Запись в лог хода: запись уходит в очередь лога, файл пишет фоновый поток
+        log_fields fields;
+        fields.game = game_id;
+        fields.move = move_num;
+        fields.color = color;
+        fields.time_ms = (int)chrono::duration<double, milli>(end - start).count();
+        game_log().write(LogLevel::INFO, fields, "Bot turn");
+        fields.time_ms = -1;
+        if (logic.from_book || logic.from_ponder)
+        {
+            // ход из дебютной книги или найденный, пока думал человек: поиска не было
+            if (logic.from_book)
+                game_log().write(LogLevel::INFO, fields, "Bot book move");
+            else
+                game_log().write(LogLevel::INFO, fields, "Bot ponder hit: depth " + to_string(logic.depth_reached));
+            return Response::OK;
+        }
+        // Статистика поиска: узлы в секунду всех потоков, узлы каждого потока и во сколько раз потоки
+        // вместе просмотрели больше узлов, чем главный
+        const double search_sec = max(1e-6, chrono::duration<double>(search_end - start).count());
+        size_t total_nodes = 0;
+        for (auto thread_nodes : logic.thread_nodes)
+            total_nodes += thread_nodes;
+        ostringstream text;
+        text << "Bot search: depth " << logic.depth_reached << ", threads " << logic.thread_nodes.size() << ", nodes "
+             << total_nodes << ", nodes per sec " << size_t(total_nodes / search_sec) << ", per thread";
+        for (auto thread_nodes : logic.thread_nodes)
+            text << " " << size_t(thread_nodes / search_sec);
+        text << ", speedup " << double(total_nodes) / max<size_t>(1, logic.thread_nodes[0]);
+        game_log().write(LogLevel::INFO, fields, text.str());
+        // Счётчики поиска всех потоков: доля отсечений, отсечения первым ходом, попадания в таблицу, ветвление
+        if (search_stats::enabled)
+        {
+            ostringstream stats;
+            stats << "Bot search stats: ";
+            logic.stats.write(stats);
+            game_log().write(LogLevel::INFO, fields, stats.str());
+        }
+        return Response::OK;
     }
 
     // Функция отвечает за ход игрока (человека) в игре
@@ -247,7 +330,7 @@ class Game
         beat_series = 1; // Устанавливаем начальное значение серии
         while (true)
         {
-            logic.find_turns(pos.x2, pos.y2); // Ищем возможные ходы для продолжения взятия
+            logic.find_turns(pos.x2, pos.y2, board.get_board()); // Ищем возможные ходы для продолжения взятия
             if (!logic.have_beats) // Если больше нет взятий, выходим из цикла
                 break;
 
@@ -303,4 +386,6 @@ class Game
     Logic logic;
     int beat_series;
     bool is_replay = false;
+    int game_id = 0; // номер партии в логе
+    static const int FRAME_MS = 16; // длительность кадра, пока бот думает
 };
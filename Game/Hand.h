@@ -64,6 +64,35 @@ class Hand
         return {resp, xc, yc};
     }
 
+    // Обработка накопившихся событий без ожидания, пока думает бот: выход, отмена хода, новая игра
+    // и изменение размера окна. Клики по доске игнорируются. Response::OK - ничего не нажато
+    Response poll() const
+    {
+        SDL_Event windowEvent;
+        while (SDL_PollEvent(&windowEvent))
+        {
+            switch (windowEvent.type)
+            {
+            case SDL_QUIT:
+                return Response::QUIT;
+            case SDL_MOUSEBUTTONDOWN: {
+                int xc = int(windowEvent.motion.y / (board->H / 10) - 1);
+                int yc = int(windowEvent.motion.x / (board->W / 10) - 1);
+                if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
+                    return Response::BACK;
+                if (xc == -1 && yc == 8)
+                    return Response::REPLAY;
+            }
+            break;
+            case SDL_WINDOWEVENT:
+                if (windowEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                    board->reset_window_size();
+                break;
+            }
+        }
+        return Response::OK;
+    }
+
     Response wait() const // Ожидание действий после окончания игры
     {
         SDL_Event windowEvent;
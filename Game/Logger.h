@@ -0,0 +1,278 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../Models/Project_path.h"
+
+using namespace std;
+
+// Уровни записей лога. ERR, а не ERROR: ERROR - макрос windows.h
+enum class LogLevel
+{
+    DEBUG,
+    INFO,
+    WARNING,
+    ERR
+};
+
+// уровень по имени из настроек (Debug, Info, Warning, Error), незнакомое имя - Info
+inline LogLevel log_level_from_name(const string &name)
+{
+    if (name == "Debug")
+        return LogLevel::DEBUG;
+    if (name == "Warning")
+        return LogLevel::WARNING;
+    if (name == "Error")
+        return LogLevel::ERR;
+    return LogLevel::INFO;
+}
+
+// Поля записи; -1 - поле не относится к записи и не печатается
+struct log_fields
+{
+    int game = -1;    // номер партии в процессе
+    int move = -1;    // номер хода в партии, с 1
+    int color = -1;   // 0 - белые, 1 - чёрные
+    int time_ms = -1; // длительность в миллисекундах
+};
+
+const size_t LOG_TEXT = 240;       // байт текста в одной записи, с завершающим нулём
+const size_t LOG_MAX_RECORDS = 16; // записей на строку: текст длиннее 16 * 239 байт обрезается с пометкой
+
+// Запись фиксированного размера: кладётся в очередь без выделения памяти. Длинный текст занимает несколько
+// записей подряд, у всех кроме последней поднят more
+struct log_record
+{
+    LogLevel level = LogLevel::INFO;
+    log_fields fields;
+    bool more = false; // текст строки продолжается в следующей записи
+    char text[LOG_TEXT] = {};
+};
+
+// Асинхронный лог. Записи из любых потоков попадают в кольцевой буфер без блокировок (очередь Вьюкова на
+// много писателей), а один фоновый поток забирает их пачками и дописывает в файл одной записью на пачку.
+// Поток, который пишет в лог, не ждёт файловую систему; строки разных потоков не перемешиваются: записи
+// длинной строки занимают места в очереди подряд. Если буфер полон, строка отбрасывается, а число отброшенных
+// попадает в лог, как и число строк, обрезанных по LOG_MAX_RECORDS
+class Logger
+{
+  public:
+    explicit Logger(const string &path, const size_t capacity = 1024) : fout(path, ios_base::trunc)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        mask = size - 1;
+        cells.reset(new log_cell[size]);
+        for (size_t i = 0; i < size; ++i)
+            cells[i].seq.store(i, memory_order_relaxed);
+        writer = thread([this] { write_loop(); });
+    }
+
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    // дописывает все записи, оставшиеся в буфере
+    ~Logger()
+    {
+        stopping = true;
+        writer.join();
+    }
+
+    void set_level(const LogLevel level)
+    {
+        min_level.store(level, memory_order_relaxed);
+    }
+
+    bool enabled(const LogLevel level) const
+    {
+        return level >= min_level.load(memory_order_relaxed);
+    }
+
+    // номер новой партии: уникален в процессе, даже когда партии идут параллельно
+    int new_game()
+    {
+        return ++games;
+    }
+
+    void write(const LogLevel level, const log_fields &fields, const string &text)
+    {
+        if (!enabled(level))
+            return;
+        const size_t chunk = LOG_TEXT - 1;
+        size_t count = max<size_t>(1, (text.size() + chunk - 1) / chunk);
+        const bool cut = (count > LOG_MAX_RECORDS);
+        if (cut)
+            count = LOG_MAX_RECORDS;
+        size_t pos;
+        if (!reserve(count, pos))
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        if (cut)
+            truncated.fetch_add(1, memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i)
+        {
+            log_cell &cell = cells[(pos + i) & mask];
+            log_record &rec = cell.rec;
+            rec.level = level;
+            rec.fields = fields;
+            rec.more = (i + 1 < count);
+            const size_t len = min(chunk, text.size() - min(text.size(), i * chunk));
+            memcpy(rec.text, text.data() + i * chunk, len);
+            rec.text[len] = 0;
+            if (cut && !rec.more) // обрезанная строка кончается многоточием
+                memcpy(rec.text + len - 3, "...", 3);
+            cell.seq.store(pos + i + 1, memory_order_release);
+        }
+    }
+
+  private:
+    struct log_cell
+    {
+        atomic<size_t> seq{0}; // номер позиции, которую ячейка ждёт: для записи - pos, для чтения - pos + 1
+        log_record rec;
+    };
+
+    // Занимает count мест очереди подряд, начиная с pos. Ячейки освобождает по порядку один фоновый поток,
+    // поэтому если свободна последняя из них, свободны и все до неё
+    bool reserve(const size_t count, size_t &pos)
+    {
+        if (count > mask + 1)
+            return false;
+        pos = tail.load(memory_order_relaxed);
+        while (true)
+        {
+            const size_t last = pos + count - 1;
+            const size_t seq = cells[last & mask].seq.load(memory_order_acquire);
+            const ptrdiff_t diff = ptrdiff_t(seq) - ptrdiff_t(last);
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + count, memory_order_relaxed))
+                    return true;
+            }
+            else if (diff < 0)
+                return false; // буфер полон
+            else
+                pos = tail.load(memory_order_relaxed);
+        }
+    }
+
+    bool pop(log_record &rec)
+    {
+        size_t pos = head.load(memory_order_relaxed);
+        log_cell *cell;
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            const size_t seq = cell->seq.load(memory_order_acquire);
+            const ptrdiff_t diff = ptrdiff_t(seq) - ptrdiff_t(pos + 1);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // буфер пуст
+            else
+                pos = head.load(memory_order_relaxed);
+        }
+        rec = cell->rec;
+        cell->seq.store(pos + mask + 1, memory_order_release);
+        return true;
+    }
+
+    static const char *level_name(const LogLevel level)
+    {
+        static const char *names[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+        return names[int(level)];
+    }
+
+    // строка файла: уровень, заданные поля в виде имя=значение и текст; запись-продолжение (continued)
+    // добавляет только текст, перевод строки ставит последняя запись строки
+    static void format(const log_record &rec, const bool continued, string &out)
+    {
+        if (continued)
+        {
+            out += rec.text;
+            if (!rec.more)
+                out += '\n';
+            return;
+        }
+        char line[384];
+        int len = snprintf(line, sizeof(line), "%s", level_name(rec.level));
+        auto field = [&](const char *name, const int value) {
+            if (value >= 0 && len < int(sizeof(line)))
+                len += snprintf(line + len, sizeof(line) - len, " %s=%d", name, value);
+        };
+        field("game", rec.fields.game);
+        field("move", rec.fields.move);
+        if (rec.fields.color >= 0 && len < int(sizeof(line)))
+            len += snprintf(line + len, sizeof(line) - len, " color=%s", rec.fields.color ? "black" : "white");
+        field("time_ms", rec.fields.time_ms);
+        if (len < int(sizeof(line)))
+            snprintf(line + len, sizeof(line) - len, (rec.more ? " %s" : " %s\n"), rec.text);
+        out += line;
+    }
+
+    // фоновый поток: пока есть записи - пачками в файл, иначе спит; после остановки дописывает остаток
+    void write_loop()
+    {
+        string batch;
+        bool continued = false; // следующая запись продолжает строку (её начало могло уйти прошлой пачкой)
+        while (true)
+        {
+            const bool last = stopping.load(); // записи, положенные до остановки, уже видны
+            batch.clear();
+            log_record rec;
+            for (int i = 0; i < 256 && pop(rec); ++i)
+            {
+                format(rec, continued, batch);
+                continued = rec.more;
+            }
+            // предупреждения - только между строками, не посреди длинной строки
+            const size_t lost = (continued ? 0 : dropped.exchange(0, memory_order_relaxed));
+            if (lost)
+                batch += "WARNING log buffer full, dropped " + to_string(lost) + " records\n";
+            const size_t cut = (continued ? 0 : truncated.exchange(0, memory_order_relaxed));
+            if (cut)
+                batch += "WARNING " + to_string(cut) + " log lines longer than " +
+                         to_string(LOG_MAX_RECORDS * (LOG_TEXT - 1)) + " bytes truncated\n";
+            if (!batch.empty())
+            {
+                fout.write(batch.data(), streamsize(batch.size()));
+                fout.flush();
+                continue;
+            }
+            if (last)
+                return;
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+    }
+
+    ofstream fout;
+    unique_ptr<log_cell[]> cells;
+    size_t mask;
+    atomic<size_t> head{0}; // следующая позиция для чтения
+    atomic<size_t> tail{0}; // следующая позиция для записи
+    atomic<size_t> dropped{0};
+    atomic<size_t> truncated{0};
+    atomic<LogLevel> min_level{LogLevel::INFO};
+    atomic<int> games{0};
+    atomic<bool> stopping{false};
+    thread writer;
+};
+
+// лог игры log.txt, общий для всех партий и потоков процесса; файл очищается при первом обращении
+inline Logger &game_log()
+{
+    static Logger log(project_path + "log.txt");
+    return log;
+}
@@ -1,325 +1,1032 @@
 #pragma once
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <atomic>
+#include <future>
+#include <memory>
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "../Models/Move.h"
-#include "Board.h"
+#include "Bitboard.h"
 #include "Config.h"
+#include "EvalWeights.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
+#include "SearchStats.h"
+#include "TTable.h"
+#include "Tablebase.h"
+#include "WorkStealing.h"
 
 const int INF = 1e9;
+const int SCORE_EPS = 1; // ширина нулевого окна: оценки целые
+const int ASPIRATION_WINDOW = 25; // полуширина окна корня вокруг оценки прошлой итерации
+const int ASPIRATION_LIMIT = 500; // окно шире этого заменяется полным
+const int SPLIT_MIN_DEPTH = 3; // YBWC делит узел между потоками, только если до горизонта не меньше стольких ходов
+
+// Настройки поиска, которые известны при компиляции ядра: Logic выбирает сочетание один раз в конструкторе,
+// и у каждого сочетания своё ядро поиска и оценки без проверок настроек внутри
+template <bool Prune, bool Reduce, bool Potential, bool Neural> struct search_policy
+{
+    static constexpr bool prune = Prune;         // альфа-бета отсечения (всё кроме O0)
+    static constexpr bool reduce = Reduce;       // O2: поздние тихие ходы сначала смотрим на ход меньше
+    static constexpr bool potential = Potential; // NumberAndPotential: продвижение шашек и более дорогая дамка
+    static constexpr bool neural = Neural;       // NeuralNetwork: оценка нейросетью, её аккумулятор идёт за ходами
+};
+
+// Токен отмены асинхронного поиска: копии токена разделяют один флаг
+class cancel_token
+{
+  public:
+    void cancel()
+    {
+        flag->store(true, memory_order_relaxed);
+    }
+
+    shared_ptr<const atomic<bool>> get() const
+    {
+        return flag;
+    }
+
+  private:
+    shared_ptr<atomic<bool>> flag = make_shared<atomic<bool>>(false);
+};
+
+// Обдумывание на времени соперника: фоновый поиск ответа бота на предсказанный ход человека.
+// Поля результата заполняет поток обдумывания, читать их можно только после join
+struct ponder_job
+{
+    atomic<bool> stop{false};
+    thread worker;
+    Position pos;   // позиция после предсказанного хода человека
+    bool color = 0; // цвет бота
+    int max_depth = 0;
+    bool complete = false; // поиск в pos дошёл до max_depth
+    vector<move_pos> result;
+    int depth_reached = 0;
+    vector<size_t> thread_nodes;
+
+    ~ponder_job()
+    {
+        stop = true;
+        if (worker.joinable())
+            worker.join();
+    }
+};
 
 class Logic
 {
   public:
-    Logic(Board *board, Config *config) : board(board), config(config)
+    Logic(Config *config)
+        : config(config), tt(make_shared<TTable>(size_t((*config)("Bot", "HashSizeMB"))))
     {
+        no_random = (*config)("Bot", "NoRandom");
         rand_eng = std::default_random_engine (
-            !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0);
-        scoring_mode = (*config)("Bot", "BotScoringType");
-        optimization = (*config)("Bot", "Optimization");
+            !no_random ? unsigned(time(0)) : 0);
+        const string scoring_mode = (*config)("Bot", "BotScoringType");
+        const string optimization = (*config)("Bot", "Optimization");
+        const bool potential = (scoring_mode == "NumberAndPotential");
+        const bool neural = (scoring_mode == "NeuralNetwork");
+        if (optimization == "O0")
+            use_policy<false, false>(potential, neural);
+        else if (optimization == "O2")
+            use_policy<true, true>(potential, neural);
+        else
+            use_policy<true, false>(potential, neural);
+        time_limit_ms = (*config)("Bot", "BotDelayMS");
+        max_nodes = (*config)("Bot", "BotMaxNodes");
+        stable_iterations = (*config)("Bot", "BotStableIterations");
+        threads = (*config)("Bot", "BotThreads");
+        if (threads <= 0)
+            threads = max(1, int(thread::hardware_concurrency()));
+        thread_nodes.reserve(threads);
+        const string tablebase_dir = (*config)("Bot", "TablebaseDir");
+        if (!tablebase_dir.empty())
+        {
+            tablebase = make_shared<Tablebase>(project_path + tablebase_dir);
+            if (!tablebase->slices) // файлов нет - не тратим время на пробы
+                tablebase.reset();
+        }
+        const string weights_path = (*config)("Bot", "EvalWeights");
+        if (!weights_path.empty())
+            weights = load_eval_weights(project_path + weights_path);
+        if (neural)
+        {
+            // без файла сети - сеть, повторяющая оценку NumberAndPotential с этими весами
+            auto net = make_shared<nnue_network>(weights);
+            const string network_path = (*config)("Bot", "NeuralNetwork");
+            if (!network_path.empty())
+                net->load(project_path + network_path);
+            network = net;
+        }
+        const string book_path = (*config)("Bot", "OpeningBook");
+        if (!book_path.empty())
+        {
+            book = make_shared<OpeningBook>(project_path + book_path);
+            if (!book->size())
+                book.reset();
+        }
+        ybwc = ((*config)("Bot", "BotParallelMode") == "YBWC");
+        // детерминированный режим: результат не зависит ни от числа потоков, ни от скорости машины
+        deterministic = (ybwc && no_random);
+        if (deterministic)
+        {
+            time_limit_ms = 0;
+            max_nodes = 0;
+            stable_iterations = 0;
+        }
+    }
+
+    // Поиск лучшего хода. При BotThreads > 1 работает один из параллельных режимов (BotParallelMode):
+    // Lazy SMP - вспомогательные потоки ищут ту же позицию со сдвигом глубины и другим порядком ходов в корне,
+    // а находки попадают к главному потоку через общую таблицу транспозиций;
+    // YBWC - главный поток ищет сам, а узлы дерева после просмотра первого хода делятся между потоками (split_point).
+    // Ход выбирает только главный поток
+    // Асинхронный поиск: ход ищется в отдельном потоке, результат забирается из future. После token.cancel()
+    // поиск прерывается на любой глубине, и его результат нужно отбросить. Пока future не готов,
+    // объект Logic нельзя использовать из других потоков
+    future<vector<move_pos>> find_best_turns_async(const Position &start, const bool color, const cancel_token &token)
+    {
+        cancel = token.get();
+        return async(launch::async, [this, start, color] {
+            auto res = find_best_turns(start, color);
+            cancel.reset();
+            return res;
+        });
     }
 
-    vector<move_pos> find_best_turns(const bool color)
+    vector<move_pos> find_best_turns(const Position &start, const bool color)
     {
-        // очищаем вектора
-        next_move.clear();
-        next_best_state.clear();
-        
-        find_first_best_turn(board->get_board(), color, -1, -1, 0); // находим лучший первый ход
+        // позиция из дебютной книги - ход сразу, без поиска
+        from_book = false;
+        from_ponder = false;
+        if (book)
+        {
+            auto res = book->find_turns(start, color, no_random, rand_eng);
+            if (!res.empty())
+            {
+                from_book = true;
+                nodes = 0;
+                stats.clear();
+                depth_reached = 0;
+                thread_nodes.assign(1, 0);
+                return res;
+            }
+        }
+        // человек сделал предсказанный ход и обдумывание успело досчитать - ответ уже готов
+        if (ponder)
+        {
+            stop_ponder();
+            const auto job = ponder;
+            ponder.reset();
+            if (job->complete && job->color == color && job->pos == start && job->max_depth == Max_depth)
+            {
+                from_ponder = true;
+                nodes = 0;
+                stats.clear();
+                depth_reached = job->depth_reached;
+                thread_nodes = job->thread_nodes;
+                return job->result;
+            }
+        }
+        start_time = chrono::steady_clock::now();
+        pos = start; // позиция, на которой поиск делает и отменяет ходы
+        refresh_accumulator(0);
+        // киллеры относятся к прошлой позиции, а история только ослабляется
+        for (auto &ply_killers : killers)
+            ply_killers[0] = ply_killers[1] = bit_move(-1, -1);
+        root_best = bit_move(-1, -1);
+        for (auto &color_history : history)
+            for (auto &from_history : color_history)
+                for (auto &value : from_history)
+                    value /= 2;
+
+        atomic<bool> finished(false);
+        unique_ptr<work_pool> work;
+        if (ybwc && threads > 1)
+            work.reset(new work_pool(threads));
+        pool = work.get();
+        vector<Logic> helpers;
+        helpers.reserve(threads - 1);
+        for (int id = 1; id < threads; ++id)
+        {
+            helpers.push_back(*this);
+            helpers.back().make_helper(id, &finished);
+        }
+        vector<thread> workers;
+        for (auto &helper : helpers)
+        {
+            if (ybwc)
+                workers.emplace_back([&helper] { helper.work_loop(); });
+            else
+                workers.emplace_back([&helper, color] { helper.iterate(color); });
+        }
 
-        vector<move_pos> res; // создаем вектор результата
-        int state = 0; // начальное состояние равно нулю
-        do {
-            res.push_back(next_move[state]); // Добавляем ходы в результат
-            state = next_best_state[state]; // переходим в следующее состояние
-        } while (state != -1 && next_move[state].x != -1);
+        auto res = iterate(color);
+        finished = true; // главный поток закончил, вспомогательные останавливаются
+        for (auto &worker : workers)
+            worker.join();
+        pool = nullptr;
+
+        thread_nodes.assign(1, nodes);
+        for (auto &helper : helpers)
+        {
+            thread_nodes.push_back(helper.nodes);
+            stats.add(helper.stats);
+        }
         return res; // возвращаем результат
     }
 
-private:
-    double find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
-        double alpha = -1)
-    {
-        // заполняем вектора
-        next_move.emplace_back(-1, -1, -1, -1);
-        next_best_state.push_back(-1);
-        if (state != 0) // если state не равно нулю, просчитываем ходы
-            find_turns(x, y, mtx);
-        // создаем копии turns и have_beats
-        auto now_turns = turns;
-        auto now_have_beats = have_beats;
-
-        if (!now_have_beats && state != 0)
+    // Начинает обдумывание, пока человек ходит цветом color: фоновый поиск предсказывает его ход и ищет ответ бота
+    // уровня level. Таблица транспозиций общая, поэтому даже прерванное обдумывание ускоряет следующий поиск
+    void start_ponder(const Position &start, const bool color, const int level)
+    {
+        stop_ponder();
+        ponder = make_shared<ponder_job>();
+        Logic ponderer(*this);
+        ponderer.make_ponderer(&ponder->stop);
+        ponder_job *job = ponder.get();
+        job->worker = thread([ponderer, job, start, color, level]() mutable { ponderer.ponder_search(*job, start, color, level); });
+    }
+
+    // останавливает обдумывание и ждёт его потока; результат остаётся для find_best_turns
+    void stop_ponder()
+    {
+        if (!ponder)
+            return;
+        ponder->stop = true;
+        if (ponder->worker.joinable())
+            ponder->worker.join();
+    }
+
+  private:
+    // копия главного объекта для обдумывания: без бюджета, прерывается по флагу stop_flag в любой момент
+    void make_ponderer(const atomic<bool> *stop_flag)
+    {
+        abort_search = stop_flag;
+        pondering = true;
+        time_limit_ms = 0;
+        max_nodes = 0;
+        stable_iterations = 0;
+        ponder.reset();
+    }
+
+    // поток обдумывания: ход человека ищется на два хода мельче, затем ответ бота на полную глубину
+    void ponder_search(ponder_job &job, const Position &start, const bool color, const int level)
+    {
+        Max_depth = max(0, level - 2);
+        const auto predicted = find_best_turns(start, color);
+        if (stop || predicted.empty())
+            return;
+        Position pos = start;
+        for (auto turn : predicted)
+            pos = make_turn(pos, bit_move(turn));
+        move_list replies;
+        gen_turns(pos, !color, replies);
+        if (replies.empty())
+            return;
+        job.pos = pos;
+        job.color = !color;
+        job.max_depth = level;
+        Max_depth = level;
+        job.result = find_best_turns(pos, !color);
+        job.complete = !stop;
+        job.depth_reached = depth_reached;
+        job.thread_nodes = thread_nodes;
+    }
+
+    // Итеративное углубление: поиск на глубину 1, 2, ... Max_depth + 1, пока не кончится бюджет времени или узлов.
+    // Возвращается лучший ход последней полностью завершённой итерации
+    vector<move_pos> iterate(const bool color)
+    {
+        nodes = 0;
+        stats.clear();
+        stop = false;
+        depth_reached = 0;
+        bit_move best(-1, -1); // лучший ход последней завершённой итерации, в координаты переводится только в конце
+        int same_best = 0; // сколько итераций подряд лучший ход не менялся
+        int score = 0; // оценка прошлой итерации
+        // вспомогательные потоки с нечётным номером сразу начинают на ход глубже главного
+        for (search_depth = size_t(helper_id % 2); search_depth <= size_t(Max_depth); ++search_depth)
         {
-            return find_best_turns_rec(mtx, 1 - color, 0, alpha); // запускаем рекурсию 
+            // первую итерацию всегда доводим до конца, чтобы был ход; обдумывание прерывается когда угодно
+            can_stop = best.from != -1 || helper_id || pondering;
+            score = (this->*root_kernel)(color, score);
+            if (stop)
+                break; // итерация прервана, её результат неполный
+            depth_reached = int(search_depth) + 1;
+            score_reached = score;
+
+            if (!pv_len[0])
+                break; // ходов нет
+            root_best = pv[0][0];
+            same_best = (best == root_best ? same_best + 1 : 1);
+            best = root_best;
+            if (time_limit_ms)
+            {
+                // следующая итерация обычно дольше всех предыдущих вместе, поэтому не начинаем её после половины бюджета,
+                // и не тратим время, если лучший ход давно не меняется
+                if (elapsed_ms() * 2 > time_limit_ms || (stable_iterations && same_best >= stable_iterations))
+                    break;
+            }
         }
+        // серия взятий показывается на доске по прыжкам
+        vector<move_pos> res;
+        if (best.from == -1)
+            return res;
+        const move_list hops = turn_hops(pos, best);
+        res.reserve(hops.size());
+        for (auto hop : hops)
+            res.push_back(hop.to_move_pos());
+        return res; // возвращаем результат
+    }
 
-        double best_score = -1; // лучший счет изначально равен единице
-        for (auto turn : now_turns) // перебираем все ходы
+    // превращает копию главного объекта во вспомогательный поток: без своего бюджета, останавливается по флагу
+    // finished; в Lazy SMP ходы в корне перемешивает своим генератором
+    void make_helper(const int id, const atomic<bool> *finished)
+    {
+        helper_id = id;
+        nodes = 0;
+        stats.clear();
+        can_stop = false;
+        abort_search = finished;
+        time_limit_ms = 0;
+        max_nodes = 0;
+        stable_iterations = 0;
+        rand_eng.seed(unsigned(id) * 7919u + (no_random ? 0u : unsigned(time(0))));
+    }
+
+    // Цикл вспомогательного потока YBWC: крадёт задачи из очередей других потоков, пока главный не закончит
+    void work_loop()
+    {
+        while (!abort_search->load(memory_order_relaxed))
+        {
+            split_task task;
+            if (steal_task(task, [](const split_task &) { return true; }))
+                run_task(task);
+            else
+                this_thread::yield();
+        }
+    }
+
+    // крадёт подходящую задачу из чужих очередей, начиная со следующего потока
+    template <class Pred> bool steal_task(split_task &task, Pred pred)
+    {
+        for (int i = 1; i < threads; ++i)
+        {
+            if (pool->deques[(helper_id + i) % threads]->steal_if(task, pred))
+                return true;
+        }
+        return false;
+    }
+
+    // Просмотр одного младшего хода точки разделения в её окне. Состояние потока сохраняется, поэтому задачу
+    // можно выполнить и посреди собственного поиска, пока поток ждёт свою точку разделения
+    void run_task(const split_task &task)
+    {
+        split_point *sp = task.sp;
+        if (!sp->aborted(task.index))
+        {
+            const Position saved_pos = pos;
+            const size_t saved_depth = search_depth;
+            split_point *const saved_split = cur_split;
+            const int saved_index = cur_index;
+            const bool saved_stop = stop;
+            const int saved_acc = acc_top;
+            pos = sp->pos;
+            refresh_accumulator(acc_top + 1);
+            search_depth = sp->search_depth;
+            cur_split = sp;
+            cur_index = task.index;
+            stop = false;
+
+            const bit_move turn = sp->turns[task.index];
+            undo_rec undo;
+            if (network)
+                push_accumulator(turn);
+            make_move(pos, turn, undo);
+            const int score = (this->*task_kernel)(turn, task.index + 1, sp->color, sp->depth, sp->have_beats, sp->alpha,
+                                            sp->beta, int(sp->search_depth - sp->depth));
+            if (!stop)
+            {
+                sp->scores[task.index] = score;
+                // отсечение: младшие по порядку задачи этой точки больше не нужны
+                int cutoff = sp->cutoff.load(memory_order_relaxed);
+                while (score >= sp->beta && task.index < cutoff &&
+                       !sp->cutoff.compare_exchange_weak(cutoff, task.index, memory_order_relaxed))
+                {
+                }
+            }
+            pos = saved_pos;
+            search_depth = saved_depth;
+            cur_split = saved_split;
+            cur_index = saved_index;
+            stop = saved_stop;
+            acc_top = saved_acc;
+        }
+        sp->pending.fetch_sub(1, memory_order_release); // последним: после этого владелец может убрать точку
+    }
+
+    // Деление узла (Young Brothers Wait): первый ход уже просмотрен и не дал отсечения, остальные ходы
+    // становятся задачами в очереди потока. Пока их разбирают другие потоки, владелец выполняет свои задачи,
+    // а затем помогает только с задачами из поддеревьев этой точки. Оценки собираются в порядке ходов,
+    // поэтому лучший ход не зависит от того, какой поток что посчитал
+    void split(const move_list &now_turns, const bool now_have_beats, const bool color, const size_t depth,
+               int &alpha, const int beta, int &best_score, bit_move &best_turn)
+    {
+        split_point sp;
+        sp.parent = cur_split;
+        sp.parent_index = cur_index;
+        sp.pos = pos;
+        sp.color = color;
+        sp.depth = depth;
+        sp.search_depth = search_depth;
+        sp.have_beats = now_have_beats;
+        sp.alpha = alpha;
+        sp.beta = beta;
+        for (size_t i = 1; i < now_turns.size(); ++i)
+        {
+            sp.turns.push_back(now_turns[i]);
+            sp.scores[i - 1] = -INF - 1;
+        }
+        sp.pending = int(sp.turns.size());
+        sp.cutoff = INT_MAX;
+        // с конца очереди владелец забирает ходы по порядку, воры с начала берут самые поздние
+        for (int i = int(sp.turns.size()) - 1; i >= 0; --i)
+            pool->deques[helper_id]->push(split_task{&sp, i});
+
+        while (sp.pending.load(memory_order_acquire) > 0)
         {
-            size_t new_state = next_move.size(); 
-            double score;
-            if (now_have_beats) // если есть кого бить, то продолжаем рекурсию
+            split_task task;
+            if (pool->deques[helper_id]->pop_if(task, [&sp](const split_task &t) { return t.sp == &sp; }) ||
+                steal_task(task, [&sp](const split_task &t) { return t.sp->inside(&sp); }))
+                run_task(task);
+            else
             {
-                score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, new_state, best_score);   
+                // бюджет главного потока
+                if ((cancel && cancel->load(memory_order_relaxed)) ||
+                    (can_stop && ((abort_search && abort_search->load(memory_order_relaxed)) ||
+                                  (time_limit_ms && elapsed_ms() >= time_limit_ms))))
+                    pool->stop_all = true;
+                this_thread::yield();
             }
-            else { // если нигого не бьем
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, 0, best_score); 
+        }
+        if (pool->stop_all.load(memory_order_relaxed) || (cur_split && cur_split->aborted(cur_index)))
+            stop = true;
+        if (stop)
+            return;
+
+        const int cutoff = sp.cutoff.load(memory_order_relaxed);
+        const int last = min(cutoff, int(sp.turns.size()) - 1);
+        for (int i = 0; i <= last; ++i)
+        {
+            if (sp.scores[i] > best_score)
+            {
+                best_score = sp.scores[i];
+                best_turn = sp.turns[i];
+            }
+        }
+        alpha = max(alpha, best_score);
+        if (cutoff != INT_MAX)
+            stats.cutoff(cutoff + 1); // первый ход узла остался у владельца
+        if (cutoff != INT_MAX && !now_have_beats)
+            add_cutoff(sp.turns[cutoff], color, int(depth), int(search_depth - depth));
+    }
+
+    // Ход на позиции поиска. С оценкой нейросетью аккумулятор позиции после хода кладётся на стек
+    // из аккумулятора текущей позиции, а при отмене хода просто снимается
+    template <class P> void do_move(const bit_move turn, undo_rec &undo)
+    {
+        if (P::neural)
+            push_accumulator(turn);
+        make_move(pos, turn, undo);
+    }
+
+    template <class P> void undo_move(const bit_move turn, const undo_rec &undo)
+    {
+        unmake_move(pos, turn, undo);
+        if (P::neural)
+            --acc_top;
+    }
+
+    // вызывается до make_move: update читает фигуры позиции до хода
+    void push_accumulator(const bit_move turn)
+    {
+        if (acc_top + 1 < ACC_STACK)
+            network->update(acc_stack[acc_top], acc_stack[acc_top + 1], pos, turn);
+        ++acc_top;
+    }
+
+    // аккумулятор позиции pos, поставленной целиком (корень поиска, задача YBWC), на место top стека
+    void refresh_accumulator(const int top)
+    {
+        acc_top = top;
+        if (network && acc_top < ACC_STACK)
+            network->refresh(acc_stack[acc_top], pos);
+    }
+
+    // выбирает ядро поиска под настройки: одна ветка на сочетание, дальше в поиске настройки не проверяются
+    template <bool Prune, bool Reduce> void use_policy(const bool potential, const bool neural)
+    {
+        if (neural)
+            use_policy<search_policy<Prune, Reduce, false, true>>();
+        else if (potential)
+            use_policy<search_policy<Prune, Reduce, true, false>>();
+        else
+            use_policy<search_policy<Prune, Reduce, false, false>>();
+    }
+
+    template <class P> void use_policy()
+    {
+        root_kernel = &Logic::search_root<P>;
+        task_kernel = &Logic::search_pvs<P>;
+    }
+
+    // Поиск в корне в окне (alpha, beta). Оценки в стиле negamax: всегда с точки зрения ходящего, поэтому
+    // оценка хода соперника берётся с минусом. Лучший ход и продолжение за ним попадают в строку 0 таблицы pv
+    template <class P>
+    int find_first_best_turn(const bool color, int alpha, const int beta)
+    {
+        pv_len[0] = 0;
+        if (stop)
+            return 0;
+        stats.node(0);
+        move_list now_turns;
+        const bool now_have_beats = gen_turns(pos, color, now_turns);
+        if (now_turns.empty())
+            return -INF; // ходов нет - проигрыш
+        // сначала пробуем лучший ход из таблицы транспозиций
+        const uint64_t key = pos.hash(color);
+        tt_entry entry_data;
+        const tt_entry *entry = nullptr;
+        if (deterministic)
+        {
+            // таблицу заполняют все потоки в разном порядке, поэтому первым идёт лучший ход прошлой итерации
+            entry_data.move = root_best;
+            entry = &entry_data;
+        }
+        else
+        {
+            entry = (tt->probe(key, entry_data) ? &entry_data : nullptr);
+            stats.probe(entry != nullptr);
+        }
+        // случайность только здесь: равные по порядку ходы корня идут в случайном порядке
+        if (!no_random || helper_id)
+            shuffle(now_turns.begin(), now_turns.end(), rand_eng);
+        order_turns(now_turns, now_have_beats, color, -1, entry);
+        stats.expand();
+
+        const int alpha_start = alpha;
+        int best_score = -INF - 1;
+        bit_move best_turn = now_turns[0];
+        bool is_first = true;
+        for (auto turn : now_turns) // перебираем все ходы
+        {
+            undo_rec undo;
+            do_move<P>(turn, undo);
+            auto search_turn = [&](const int a, const int b) { return -find_best_turns_rec<P>(1 - color, 0, -b, -a); };
+            int score;
+            if (!P::prune)
+                score = search_turn(-INF - 1, INF + 1);
+            else if (is_first) // главный вариант ищем в полном окне
+                score = search_turn(alpha, beta);
+            else
+            {
+                // остальные ходы сначала проверяем нулевым окном: только докажем, что они не лучше
+                score = search_turn(alpha, alpha + SCORE_EPS);
+                if (score > alpha && score < beta)
+                    score = search_turn(alpha, beta);
             }
+            undo_move<P>(turn, undo);
+            if (stop)
+                return 0;
             if (score > best_score) { // проверяем лучше ли новый результат чем best_score
                 // если да, то обновляем информацию
                 best_score = score;
-                next_move[state] = turn;
-                next_best_state[state] = (now_have_beats ? new_state : -1);
+                best_turn = turn;
+                update_pv(0, turn);
+            }
+            alpha = max(alpha, score);
+            if (P::prune && alpha >= beta)
+            {
+                stats.cutoff(is_first ? 0 : 1);
+                break;
             }
+            is_first = false;
         }
-        return best_score; 
+        tt->store(key, int(search_depth) + 1, get_bound(best_score, alpha_start, beta), to_tt(best_score, -1),
+                  best_turn);
+        return best_score;
     }
 
-    double find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, double alpha = -1,
-        double beta = INF + 1, const POS_T x = -1, const POS_T y = -1)
+    // Поиск negamax с главным вариантом (PVS): первый ход в полном окне, остальные в нулевом.
+    // depth - номер хода от корня, серия взятий - один ход
+    template <class P>
+    int find_best_turns_rec(const bool color, const size_t depth, int alpha, const int beta)
     {
-        if (depth == Max_depth) { // условие выхода из рекурсии
-            return calc_score(mtx, (depth % 2 == color)); // возвращаем наилучший результат
-        }
-        if (x != -1) { // получаем ходы
-            find_turns(x, y, mtx); // по координатам
+        const size_t ply = depth + 1; // строка таблицы pv этого узла
+        if (ply < MAX_PLY)
+            pv_len[ply] = 0;
+        if (out_of_budget()) // бюджет хода исчерпан, результат будет отброшен
+            return 0;
+        stats.node(ply);
+        // в эндшпиле из таблиц известен точный результат и число ходов до него: чем быстрее выигрыш, тем лучше
+        if (tablebase)
+        {
+            const int value = tablebase->probe(pos, color);
+            if (value == TB_DRAW)
+                return 0;
+            if (value > 0)
+            {
+                const int end_depth = int(depth) + value - 1; // номер хода, на котором у проигравшего нет ходов
+                return ((value - 1) % 2 ? INF - end_depth : -(INF - end_depth));
+            }
         }
-        else {
-            find_turns(color, mtx); // по цвету
+        if (depth >= search_depth) { // условие выхода из рекурсии
+            return quiescence<P>(color, depth, alpha, beta); // доигрываем взятия и оцениваем позицию
         }
-        // сохраняем новое значение
-        auto now_turns = turns;
-        auto now_have_beats = have_beats;
-        if (!now_have_beats && x != -1) {
-            return find_best_turns_rec(mtx, 1 - color, depth + 1, alpha, beta); // запускаем рекурсию 
+        move_list now_turns;
+        const bool now_have_beats = gen_turns(pos, color, now_turns);
+        if (now_turns.empty()) { // если ходов нету
+            return -(INF - int(depth)); // значит мы проиграли, чем позже - тем лучше
         }
 
-        if (turns.empty()) { // если ходов нету
-            return (depth % 2 ? 0 : INF); // значит мы либо проиграли, либо выиграли
+        // проверяем таблицу транспозиций: оценка с достаточной глубины может сразу дать ответ,
+        // а лучший ход из неё перебираем первым
+        const int remaining = int(search_depth - depth);
+        const int alpha_start = alpha;
+        const uint64_t key = pos.hash(color);
+        tt_entry entry_data;
+        const tt_entry *entry = (tt->probe(key, entry_data) ? &entry_data : nullptr);
+        stats.probe(entry != nullptr);
+        if (entry && entry->depth >= remaining && !deterministic)
+        {
+            const int score = from_tt(entry->score, int(depth));
+            if (entry->bound == Bound::EXACT || (entry->bound == Bound::LOWER && score >= beta) ||
+                (entry->bound == Bound::UPPER && score <= alpha))
+                return score;
         }
+        order_turns(now_turns, now_have_beats, color, int(depth), entry);
+        stats.expand();
 
         // иначе считаем лучшие ходы
-        double min_score = INF + 1;
-        double max_score = -1;
+        int best_score = -INF - 1;
+        bit_move best_turn = now_turns[0];
+        int turn_num = 0;
         for (auto turn : now_turns) {
-            double score; 
-            if (now_have_beats) { // если есть побития то продолжаем серию
-                score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
-            }
-            else {
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, depth + 1, alpha, beta);
-            }
-            // обновление минимума и максимума
-            min_score = min(min_score, score); 
-            max_score = max(max_score, score); 
-            // делаем альфа и бета отсечения
-            if (depth % 2) { // если ходим мы то двигаем левую границу
-                alpha = max(alpha, max_score);
+            undo_rec undo;
+            do_move<P>(turn, undo);
+            const int score = search_pvs<P>(turn, turn_num, color, depth, now_have_beats, alpha, beta, remaining);
+            undo_move<P>(turn, undo); // возвращаем позицию к исходной
+            if (stop)
+                return 0;
+            if (score > best_score) {
+                best_score = score;
+                best_turn = turn;
             }
-            else { // иначе правую
-                beta = min(beta, min_score);
+            if (score > alpha) {
+                alpha = score;
+                update_pv(ply, turn);
             }
-            // проверяем уровень оптимизации
-            if (optimization != "O0" && alpha > beta) {
+            // отсечение: соперник не допустит этой позиции
+            if (P::prune && alpha >= beta) {
+                stats.cutoff(turn_num);
+                if (!now_have_beats) // тихий ход, давший отсечение, запоминаем для сортировки
+                    add_cutoff(turn, color, int(depth), remaining);
                 break;
             }
-            if (optimization == "O2" && alpha == beta) {
-                return (depth % 2 ? max_score + 1 : min_score - 1);
+            // старший ход просмотрен: остальные можно смотреть параллельно
+            if (pool && P::prune && turn_num == 0 && remaining >= SPLIT_MIN_DEPTH && now_turns.size() > 1)
+            {
+                const bit_move first_turn = best_turn;
+                split(now_turns, now_have_beats, color, depth, alpha, beta, best_score, best_turn);
+                if (stop)
+                    return 0;
+                // продолжения младших ходов остались в таблицах других потоков, от них известен только сам ход
+                if (best_turn != first_turn && ply < MAX_PLY)
+                {
+                    pv[ply][0] = best_turn;
+                    pv_len[ply] = 1;
+                }
+                break;
             }
+            ++turn_num;
         }
-        return (depth % 2 ? max_score : min_score); // возвращаем результат
+        if (deterministic) // fail-hard: оценка за окном не зависит от порядка просмотра ходов
+            best_score = max(alpha_start, min(best_score, beta));
+        // сохраняем результат вместе с типом границы относительно исходного окна
+        tt->store(key, remaining, get_bound(best_score, alpha_start, beta), to_tt(best_score, int(depth)), best_turn);
+        return best_score; // возвращаем результат
     }
 
-    vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const // производит ход на матрице, возвращает её копию
+    // ход turn стал лучшим в узле строки ply: главный вариант узла - этот ход и главный вариант после него
+    void update_pv(const size_t ply, const bit_move turn)
     {
-        if (turn.xb != -1)
-            mtx[turn.xb][turn.yb] = 0;
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2;
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
-        mtx[turn.x][turn.y] = 0;
-        return mtx;
+        if (ply >= MAX_PLY)
+            return;
+        pv[ply][0] = turn;
+        const int child_len = (ply + 1 < MAX_PLY ? pv_len[ply + 1] : 0);
+        for (int i = 0; i < child_len; ++i)
+            pv[ply][i + 1] = pv[ply + 1][i];
+        pv_len[ply] = child_len + 1;
     }
 
-    double calc_score(const vector<vector<POS_T>> &mtx, const bool first_bot_color) const
+    // Просмотр хода turn узла (ход уже сделан на pos) с главным вариантом: первый ход в полном окне,
+    // остальные сначала в нулевом. turn_num - номер хода в порядке перебора
+    template <class P>
+    int search_pvs(const bit_move turn, const int turn_num, const bool color, const size_t depth,
+                      const bool now_have_beats, const int alpha, const int beta, const int remaining)
     {
-        // color - who is max player
-        double w = 0, wq = 0, b = 0, bq = 0;
-        for (POS_T i = 0; i < 8; ++i)  // подсчитывает количество белых и черных пешек и королев
+        // reduction - на сколько ходов сократить глубину просмотра
+        auto search_turn = [&](const int a, const int b, const size_t reduction = 0) {
+            return -find_best_turns_rec<P>(1 - color, depth + 1 + reduction, -b, -a);
+        };
+        if (!P::prune)
+            return search_turn(-INF - 1, INF + 1);
+        if (turn_num == 0) // главный вариант ищем в полном окне
+            return search_turn(alpha, beta);
+        // в O2 поздние тихие ходы сначала смотрим на ход меньше
+        const bool reduce = (P::reduce && !deterministic && !now_have_beats && turn_num >= 3 &&
+                             remaining >= 3 &&
+                             (depth >= MAX_PLY || (turn != killers[depth][0] && turn != killers[depth][1])));
+        int score = search_turn(alpha, alpha + SCORE_EPS, reduce);
+        if (reduce && score > alpha)
+            score = search_turn(alpha, alpha + SCORE_EPS);
+        if (score > alpha && score < beta)
+            score = search_turn(alpha, beta);
+        return score;
+    }
+
+    // Поиск за горизонтом: пока у ходящего есть взятия, они обязательны и перебираются дальше,
+    // позиция оценивается только когда взятий нет
+    template <class P>
+    int quiescence(const bool color, const size_t depth, int alpha, const int beta)
+    {
+        if (out_of_budget())
+            return 0;
+        if (!has_beats(pos, color))
+            return calc_score<P>(color, depth); // тихая позиция: оцениваем без генерации ходов
+        move_list now_turns;
+        gen_beats(pos, color, now_turns);
+        order_turns(now_turns, true, color, -1, nullptr);
+
+        const int alpha_start = alpha;
+        int best_score = -INF - 1;
+        for (auto turn : now_turns)
         {
-            for (POS_T j = 0; j < 8; ++j)
-            { 
-                w += (mtx[i][j] == 1);
-                wq += (mtx[i][j] == 3);
-                b += (mtx[i][j] == 2);
-                bq += (mtx[i][j] == 4);
-                if (scoring_mode == "NumberAndPotential")
-                {
-                    w += 0.05 * (mtx[i][j] == 1) * (7 - i);
-                    b += 0.05 * (mtx[i][j] == 2) * (i);
-                }
-            }
+            undo_rec undo;
+            do_move<P>(turn, undo);
+            const int score = -quiescence<P>(1 - color, depth + 1, -beta, -alpha);
+            undo_move<P>(turn, undo);
+            if (stop)
+                return 0;
+            best_score = max(best_score, score);
+            alpha = max(alpha, score);
+            if (P::prune && alpha >= beta)
+                break;
+        }
+        if (deterministic)
+            best_score = max(alpha_start, min(best_score, beta));
+        return best_score;
+    }
+
+    static Bound get_bound(const int score, const int alpha, const int beta)
+    {
+        return (score <= alpha ? Bound::UPPER : (score >= beta ? Bound::LOWER : Bound::EXACT));
+    }
+
+    // оценки выигрыша и проигрыша зависят от номера хода, в таблице они хранятся относительно самой позиции
+    static int to_tt(const int score, const int depth)
+    {
+        return (score > INF / 2 ? score + depth : (score < -INF / 2 ? score - depth : score));
+    }
+
+    static int from_tt(const int score, const int depth)
+    {
+        return (score > INF / 2 ? score - depth : (score < -INF / 2 ? score + depth : score));
+    }
+
+    // Одна итерация в корне с окном стремления (aspiration window) вокруг оценки прошлой итерации:
+    // если оценка вышла за окно, окно расширяется и поиск повторяется
+    template <class P>
+    int search_root(const bool color, const int prev_score)
+    {
+        int delta = ASPIRATION_WINDOW;
+        const bool use_window = (P::prune && search_depth > 0 && abs(prev_score) < INF / 2);
+        int alpha = (use_window ? prev_score - delta : -INF - 1);
+        int beta = (use_window ? prev_score + delta : INF + 1);
+        while (true)
+        {
+            const int score = find_first_best_turn<P>(color, alpha, beta); // находим лучший первый ход
+            if (stop || (score > alpha && score < beta))
+                return score;
+            delta *= 4;
+            if (score <= alpha)
+                alpha = (delta > ASPIRATION_LIMIT ? -INF - 1 : score - delta);
+            else
+                beta = (delta > ASPIRATION_LIMIT ? INF + 1 : score + delta);
         }
-        if (!first_bot_color)
+    }
+
+    // считает узлы и раз в 1024 узла проверяет время; выставляет stop, когда бюджет кончился.
+    // В YBWC раз в 64 узла ещё проверяет, не отменена ли выполняемая задача
+    bool out_of_budget()
+    {
+        ++nodes;
+        if (stop)
+            return true;
+        if (cancel && nodes % 64 == 0 && cancel->load(memory_order_relaxed)) // поиск отменён - и первая итерация
         {
-            swap(b, w);
-            swap(bq, wq);
-        }
-        if (w + wq == 0)
-            return INF; // возвращает бесконечность если нет белых
-        if (b + bq == 0)
-            return 0; // возвращает 0 если нет черных
-        int q_coef = 4; // вес дамки
-        if (scoring_mode == "NumberAndPotential")
+            stop = true;
+            if (pool)
+                pool->stop_all = true;
+            return true;
+        }
+        if (pool && nodes % 64 == 0 &&
+            (pool->stop_all.load(memory_order_relaxed) || (cur_split && cur_split->aborted(cur_index))))
+            stop = true;
+        else if (can_stop && budget_spent())
         {
-            q_coef = 5;
+            stop = true;
+            if (pool) // бюджет есть только у главного потока, остальные бросают работу по его флагу
+                pool->stop_all = true;
         }
-        return (b + bq * q_coef) / (w + wq * q_coef); // иначе возвращает общий счет высчитанный по этой формуле
+        return stop;
     }
 
-public:
-    void find_turns(const bool color) // принимает цвет, вызывает другую функцию которая ищет возможные ходы
+    bool budget_spent() const
     {
-        find_turns(color, board->get_board());
+        return (abort_search && abort_search->load(memory_order_relaxed)) || (max_nodes && nodes >= max_nodes) ||
+               (time_limit_ms && nodes % 1024 == 0 && elapsed_ms() >= time_limit_ms);
     }
 
-    void find_turns(const POS_T x, const POS_T y) // аналогично предыдущей, но принимает не цвет а координаты 
+    size_t elapsed_ms() const
     {
-        find_turns(x, y, board->get_board()); 
+        return size_t(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start_time).count());
     }
 
-private:
-    void find_turns(const bool color, const vector<vector<POS_T>> &mtx) // ищет ходы. принимает цвет ходящего, а так же матрицу с состоянием поля 
+    // Сортировка ходов перед перебором: ход из таблицы транспозиций, затем взятия (сначала дамок и с превращением),
+    // затем ходы-киллеры этой глубины, затем остальные тихие ходы по таблице истории
+    void order_turns(move_list &now_turns, const bool now_have_beats, const bool color, const int depth,
+                     const tt_entry *entry) const
     {
-        vector<move_pos> res_turns;
-        bool have_beats_before = false;
-        for (POS_T i = 0; i < 8; ++i) // проходимся по всем глеткам
+        const bool has_killers = (depth >= 0 && depth < MAX_PLY && !now_have_beats);
+        auto order_score = [&](const bit_move turn) {
+            if (entry && turn == entry->move)
+                return 1 << 30;
+            if (now_have_beats) // сначала серии, бьющие больше и дороже, затем с превращением
+                return (1 << 20) + 4 * pop_count(turn.caps) + 2 * pop_count(turn.caps & pos.kings) +
+                       (!(pos.kings & sq_mask(turn.from)) &&
+                        (turn.promote || (PROMOTE_ROW[color] & sq_mask(turn.to)) != 0));
+            if (has_killers && turn == killers[depth][0])
+                return (1 << 19) + 1;
+            if (has_killers && turn == killers[depth][1])
+                return 1 << 19;
+            if (deterministic && depth < 0) // история зависит от того, какие задачи достались потоку
+                return 0;
+            return history[color][turn.from][turn.to];
+        };
+        // устойчивая сортировка вставками по заранее посчитанным очкам: ходов мало, и куча не нужна
+        int scores[MAX_TURNS];
+        for (size_t i = 0; i < now_turns.size(); ++i)
         {
-            for (POS_T j = 0; j < 8; ++j)
+            const bit_move turn = now_turns[i];
+            const int score = order_score(turn);
+            size_t j = i;
+            for (; j > 0 && scores[j - 1] < score; --j)
             {
-                if (mtx[i][j] && mtx[i][j] % 2 != color) // если клетка совпадает с выбранным цветом, то выполняем еще один find turns, но уже от этой клетки
-                {
-                    find_turns(i, j, mtx);
-                    if (have_beats && !have_beats_before)
-                    {
-                        have_beats_before = true;
-                        res_turns.clear();
-                    }
-                    if ((have_beats_before && have_beats) || !have_beats_before)
-                    {
-                        res_turns.insert(res_turns.end(), turns.begin(), turns.end());
-                    }
-                }
+                scores[j] = scores[j - 1];
+                now_turns[j] = now_turns[j - 1];
             }
+            scores[j] = score;
+            now_turns[j] = turn;
         }
-        turns = res_turns;
-        shuffle(turns.begin(), turns.end(), rand_eng);
-        have_beats = have_beats_before;
     }
 
-    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>> &mtx) // тоже ищет возможные ходы, но принимает позицию а не цвет
+    // тихий ход дал отсечение: он становится киллером глубины и получает очки истории
+    void add_cutoff(const bit_move turn, const bool color, const int depth, const int remaining)
     {
-        turns.clear();
-        have_beats = false;
-        POS_T type = mtx[x][y];
-        // check beats
-        switch (type) // проверяет тип фигуры
-        { // логика побитий
-        case 1:
-        case 2:
-            // check pieces
-            for (POS_T i = x - 2; i <= x + 2; i += 4)
-            {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7)
-                        continue;
-                    POS_T xb = (x + i) / 2, yb = (y + j) / 2;
-                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, xb, yb);
-                }
-            }
-            break;
-        default:
-            // check queens
-            for (POS_T i = -1; i <= 1; i += 2)
-            {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    POS_T xb = -1, yb = -1;
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                        {
-                            if (mtx[i2][j2] % 2 == type % 2 || (mtx[i2][j2] % 2 != type % 2 && xb != -1))
-                            {
-                                break;
-                            }
-                            xb = i2;
-                            yb = j2;
-                        }
-                        if (xb != -1 && xb != i2)
-                        {
-                            turns.emplace_back(x, y, i2, j2, xb, yb);
-                        }
-                    }
-                }
-            }
-            break;
+        if (depth < MAX_PLY && turn != killers[depth][0])
+        {
+            killers[depth][1] = killers[depth][0];
+            killers[depth][0] = turn;
         }
-        // check other turns
-        if (!turns.empty())
+        int &value = history[color][turn.from][turn.to];
+        value += remaining * remaining;
+        if (value >= (1 << 18)) // не даём истории догнать киллеров
         {
-            have_beats = true;
-            return;
+            for (auto &color_history : history)
+                for (auto &from_history : color_history)
+                    for (auto &v : from_history)
+                        v /= 2;
         }
-        switch (type)
+    }
+
+    // Оценка позиции с точки зрения ходящего цвета color: разность его материала и материала соперника
+    // в сотых долях шашки, поэтому оценка соперника - та же величина с минусом. Счётчики фигур и продвижения
+    // ведёт make_move / unmake_move, так что лист стоит нескольких сложений. NeuralNetwork - выход нейросети
+    // по аккумулятору позиции, который ведёт do_move / undo_move
+    template <class P>
+    int calc_score(const bool color, const size_t depth) const
+    {
+        const int own = pos.men_count[color] + pos.king_count[color];
+        const int other = pos.men_count[!color] + pos.king_count[!color];
+        if (own == 0)
+            return -(INF - int(depth)); // фигур нет - проигрыш
+        if (other == 0)
+            return INF - int(depth) - 1; // у соперника фигур нет - выигрыш
+        if (P::neural)
         {
-        case 1:
-        case 2:
-            // check pieces
-            {
-                POS_T i = ((type % 2) ? x - 1 : x + 1);
-                for (POS_T j = y - 1; j <= y + 1; j += 2)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7 || mtx[i][j])
-                        continue;
-                    turns.emplace_back(x, y, i, j);
-                }
-                break;
-            }
-        default:
-            // check queens
-            for (POS_T i = -1; i <= 1; i += 2)
-            {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                            break;
-                        turns.emplace_back(x, y, i2, j2);
-                    }
-                }
-            }
-            break;
+            if (acc_top < ACC_STACK)
+                return network->evaluate(acc_stack[acc_top], color);
+            nnue_accumulator acc; // стек кончился: считаем аккумулятор заново
+            network->refresh(acc, pos);
+            return network->evaluate(acc, color);
         }
+        return material_score<P::potential>(pos, color, weights);
+    }
+
+public:
+    // Ходы для окна: доска приходит матрицей, поэтому Logic не зависит от SDL и работает и без окна
+    void find_turns(const bool color, const vector<vector<POS_T>> &mtx) // ищет ходы. принимает цвет ходящего, а так же матрицу с состоянием поля 
+    {
+        move_list res_turns;
+        have_beats = gen_hops(Position(mtx), color, res_turns);
+        set_turns(res_turns);
+    }
+
+    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>> &mtx) // тоже ищет возможные ходы, но принимает позицию а не цвет
+    {
+        move_list res_turns;
+        have_beats = gen_hops(Position(mtx), square(x, y), res_turns);
+        set_turns(res_turns);
+    }
+
+private:
+    void set_turns(const move_list &res_turns) // переводит ходы битовой доски в координаты
+    {
+        turns.clear();
+        for (auto turn : res_turns)
+            turns.push_back(turn.to_move_pos());
     }
 
   public:
     vector<move_pos> turns; // ходы которые были найдены с помощью функции find_turns
     bool have_beats; // флажёк, маркирующий, являются ли наши ходы побитиями
     int Max_depth; // максимальная глубина просчета
+    size_t nodes = 0; // количество узлов, просмотренных последним поиском
+    size_t search_depth = 0; // глубина последней итерации поиска
+    int depth_reached = 0; // глубина в ходах последней завершённой итерации
+    int score_reached = 0; // оценка последней завершённой итерации с точки зрения ходящего
+    bool from_book = false; // последний ход взят из дебютной книги
+    bool from_ponder = false; // последний ход найден заранее, пока думал человек
+    vector<size_t> thread_nodes; // узлы каждого потока последнего поиска, первым идёт главный
+    eval_weights weights; // веса оценки, из файла EvalWeights или по умолчанию
+    search_stats stats; // счётчики последнего поиска всех потоков (пустые при SEARCH_STATS=0)
 
   private:
+    bool no_random; // детерминированный бот
     default_random_engine rand_eng; // хранит тип способа получения случайностей
-    string scoring_mode; // отвечал за оценку поля
-    string optimization; // отвечает за тип оптимизации (есть 3 типа)
-    // два вектора, отвечающие за восстановление последовательности ходов
-    vector<move_pos> next_move;
-    vector<int> next_best_state;
-    Board *board; // указатель на объект класса доска
+    // ядро поиска, собранное под BotScoringType и Optimization: итерация в корне и просмотр хода задачи YBWC
+    int (Logic::*root_kernel)(bool, int);
+    int (Logic::*task_kernel)(bit_move, int, bool, size_t, bool, int, int, int);
+    // бюджет хода: время (0 - без ограничения), узлы (0 - без ограничения) и число итераций с неизменным лучшим ходом
+    size_t time_limit_ms;
+    size_t max_nodes;
+    int stable_iterations;
+    chrono::steady_clock::time_point start_time;
+    bool can_stop = false; // можно ли прерывать текущую итерацию
+    bool stop = false; // итерация прервана по бюджету
+    int threads; // число потоков поиска
+    int helper_id = 0; // 0 - главный поток, иначе номер вспомогательного потока
+    const atomic<bool> *abort_search = nullptr; // флаг остановки вспомогательного потока
+    bool ybwc; // параллельный режим YBWC вместо Lazy SMP
+    bool deterministic; // YBWC без случайности: fail-hard, без отсечений по таблице и без бюджета хода
+    work_pool *pool = nullptr; // очереди задач YBWC текущего поиска
+    split_point *cur_split = nullptr; // точка разделения выполняемой задачи (nullptr - поиск из корня)
+    int cur_index = 0; // номер выполняемой задачи в cur_split
+    bit_move root_best{-1, -1}; // лучший ход в корне прошлой итерации
+    // эвристики сортировки ходов: два хода-киллера на каждую глубину и таблица истории [цвет][откуда][куда]
+    static const int MAX_PLY = 64;
+    bit_move killers[MAX_PLY][2];
+    int history[2][32][32] = {};
+    Position pos; // позиция поиска, ходы делаются и отменяются на ней без копирования
+    // треугольная таблица главных вариантов: pv[ply] - лучшая линия узла на расстоянии ply от корня, длиной pv_len[ply]
+    bit_move pv[MAX_PLY][MAX_PLY];
+    int pv_len[MAX_PLY] = {};
     Config *config; // указатель на объект класса конфиг
+    shared_ptr<TTable> tt; // таблица транспозиций, общая для всех потоков поиска
+    shared_ptr<const Tablebase> tablebase; // эндшпильные таблицы (nullptr - не используются)
+    shared_ptr<const nnue_network> network; // нейросеть оценки (nullptr - BotScoringType не NeuralNetwork)
+    // стек аккумуляторов нейросети: acc_stack[acc_top] - аккумулятор позиции pos
+    static const int ACC_STACK = 2 * MAX_PLY;
+    nnue_accumulator acc_stack[ACC_STACK];
+    int acc_top = 0;
+    shared_ptr<const OpeningBook> book; // дебютная книга (nullptr - не используется)
+    shared_ptr<ponder_job> ponder; // последнее обдумывание (nullptr - не было)
+    bool pondering = false; // этот объект - копия для обдумывания
+    shared_ptr<const atomic<bool>> cancel; // флаг отмены асинхронного поиска (nullptr - поиск синхронный)
 };
\ No newline at end of file
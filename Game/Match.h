@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+#include "Logger.h"
+#include "Logic.h"
+
+// Партия бота против бота без окна: позиция, история и цикл ходов Game::play без SDL и без задержек показа.
+// Боты ищут на полной скорости, поэтому партии можно играть пачками на машине без экрана
+class Match
+{
+  public:
+    // white и black - боты сторон (можно один и тот же объект), уровень каждого задаёт его Max_depth;
+    // после max_turns ходов партия - ничья. Итог партии пишется в log (nullptr - никуда): log.txt игры
+    // партии без окна не трогают
+    Match(Logic *white, Logic *black, const int max_turns, Logger *log = nullptr)
+        : bots{white, black}, max_turns(max_turns), log(log)
+    {
+    }
+
+    // Играет партию из позиции start, первым ходит color. Результат как у Board::show_final:
+    // 0 - ничья по числу ходов, 1 - победа белых, 2 - победа чёрных
+    int play(const Position &start, const bool first_color)
+    {
+        const auto start_time = chrono::steady_clock::now();
+        game_id = (log ? log->new_game() : game_id + 1);
+        pos = start;
+        color = first_color;
+        history.assign(1, pos);
+        moves.clear();
+        int res = 0;
+        for (turn_num = 0; turn_num < max_turns; ++turn_num)
+        {
+            move_list turns;
+            gen_turns(pos, color, turns);
+            const auto hops = (turns.empty() ? vector<move_pos>() : bots[color]->find_best_turns(pos, color));
+            if (hops.empty()) // ходов нет - проигрыш ходящего
+            {
+                res = (color ? 1 : 2);
+                break;
+            }
+            // серия взятий приходит прыжками, как её показывает окно
+            for (auto hop : hops)
+                pos = make_turn(pos, bit_move(hop));
+            moves.push_back(hops);
+            history.push_back(pos);
+            color = !color;
+        }
+
+        if (!log)
+            return res;
+        log_fields fields;
+        fields.game = game_id;
+        fields.move = turn_num;
+        fields.time_ms = int(chrono::duration<double, milli>(chrono::steady_clock::now() - start_time).count());
+        const char *outcome = (res == 0 ? "draw" : (res == 1 ? "white won" : "black won"));
+        log->write(LogLevel::INFO, fields, string("Headless game: ") + outcome);
+        return res;
+    }
+
+    int play()
+    {
+        return play(start_position(), 0);
+    }
+
+    Position pos;   // текущая позиция партии
+    bool color = 0; // кто ходит
+    int turn_num = 0; // сколько ходов сделано
+    vector<Position> history; // позиции партии, первой идёт начальная
+    vector<vector<move_pos>> moves; // ходы партии, серия взятий - прыжками
+    int game_id = 0; // номер партии (в логе, если он есть)
+
+  private:
+    Logic *bots[2];
+    int max_turns;
+    Logger *log;
+};
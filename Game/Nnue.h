@@ -0,0 +1,279 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// ядра SIMD выбираются при компиляции: AVX2 (-mavx2 или -march=native), SSSE3, SSE2 (любой x86-64) или
+// обычные циклы на других процессорах
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define NNUE_AVX2 1
+    #define NNUE_SIMD_NAME "AVX2"
+#elif defined(__SSSE3__)
+    #include <tmmintrin.h>
+    #define NNUE_SSSE3 1
+    #define NNUE_SIMD_NAME "SSSE3"
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NNUE_SSE2 1
+    #define NNUE_SIMD_NAME "SSE2"
+#else
+    #define NNUE_SIMD_NAME "scalar"
+#endif
+
+#include "Bitboard.h"
+#include "EvalWeights.h"
+
+using namespace std;
+
+// Нейросеть оценки в стиле NNUE. Первый слой разреженный: признак - фигура одного из 4 видов (своя шашка,
+// чужая шашка, своя дамка, чужая дамка) на одной из 32 клеток, поэтому его суммы (аккумулятор) меняются
+// на несколько строк весов за ход. Аккумулятор считается с точки зрения обоих цветов: у чёрных доска повёрнута,
+// так что своя сторона всегда внизу. Дальше отсечённые в [0, 127] суммы ходящего и соперника идут в плотный
+// слой int8 и в выход; всё считается в целых числах
+const int NNUE_FEATURES = 4 * 32;
+const int NNUE_HIDDEN = 32;   // суммы первого слоя на один цвет
+const int NNUE_L1 = 16;       // нейроны плотного слоя
+const int NNUE_L1_SHIFT = 6;  // сумма плотного слоя делится на 2^6 перед отсечением
+const int NNUE_OUT_SHIFT = 1; // выход делится на 2 - оценка в сотых долях шашки
+const int NNUE_CLIP = 127;    // верхняя граница отсечения (clipped ReLU)
+
+// Файл сети - NNUE_MAGIC и массивы nnue_network в порядке объявления, числа little-endian
+const char NNUE_MAGIC[8] = {'C', 'K', 'N', 'N', 'U', 'E', '1', '\0'};
+
+// суммы первого слоя позиции: side[0] - с точки зрения белых, side[1] - чёрных
+struct nnue_accumulator
+{
+    int16_t side[2][NNUE_HIDDEN];
+};
+
+// номер признака фигуры цвета color (дамка - queen) на клетке sq с точки зрения цвета side
+inline int nnue_feature(const bool side, const bool color, const bool queen, const int sq)
+{
+    return ((color != side) + 2 * queen) * 32 + (side ? 31 - sq : sq);
+}
+
+// acc += row или acc -= row для NNUE_HIDDEN чисел int16
+template <bool Add> inline void nnue_update_row(int16_t *acc, const int16_t *row)
+{
+#if NNUE_AVX2
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        __m256i *dst = reinterpret_cast<__m256i *>(acc + i);
+        const __m256i a = _mm256_loadu_si256(dst), b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        _mm256_storeu_si256(dst, Add ? _mm256_add_epi16(a, b) : _mm256_sub_epi16(a, b));
+    }
+#elif NNUE_SSSE3 || NNUE_SSE2
+    for (int i = 0; i < NNUE_HIDDEN; i += 8)
+    {
+        __m128i *dst = reinterpret_cast<__m128i *>(acc + i);
+        const __m128i a = _mm_loadu_si128(dst), b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        _mm_storeu_si128(dst, Add ? _mm_add_epi16(a, b) : _mm_sub_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        acc[i] = int16_t(Add ? acc[i] + row[i] : acc[i] - row[i]);
+#endif
+}
+
+// суммы int16 отсекаются в [0, NNUE_CLIP] и сжимаются в байты
+inline void nnue_clip(const int16_t *acc, uint8_t *out)
+{
+#if NNUE_AVX2
+    const __m256i top = _mm256_set1_epi8(NNUE_CLIP);
+    for (int i = 0; i < NNUE_HIDDEN; i += 32)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + i + 16));
+        // packus перемежает 128-битные половины, permute возвращает порядок
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_min_epu8(packed, top));
+    }
+#elif NNUE_SSSE3 || NNUE_SSE2
+    const __m128i top = _mm_set1_epi8(NNUE_CLIP);
+    for (int i = 0; i < NNUE_HIDDEN; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_min_epu8(_mm_packus_epi16(a, b), top));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i)
+        out[i] = uint8_t(min(max(int(acc[i]), 0), NNUE_CLIP));
+#endif
+}
+
+// скалярное произведение 2 * NNUE_HIDDEN байт входа (0..127) на строку весов int8. Произведения пар
+// не больше 2 * 127 * 127, поэтому промежуточные суммы int16 не переполняются
+inline int nnue_dot(const uint8_t *in, const int8_t *weights)
+{
+#if NNUE_AVX2
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i += 32)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, w), ones));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+#elif NNUE_SSSE3
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i += 16)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(x, w), ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#elif NNUE_SSE2
+    // без SSSE3 нет умножения байт: расширяем вход и веса до int16
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    for (int i = 0; i < 2 * NNUE_HIDDEN; i += 16)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+        const __m128i sign = _mm_cmpgt_epi8(zero, w);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(w, sign)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(w, sign)));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int sum = 0;
+    for (int i = 0; i < 2 * NNUE_HIDDEN; ++i)
+        sum += int(in[i]) * int(weights[i]);
+    return sum;
+#endif
+}
+
+struct alignas(64) nnue_network
+{
+    int16_t feature_weights[NNUE_FEATURES][NNUE_HIDDEN] = {}; // строка первого слоя на каждый признак
+    int16_t feature_bias[NNUE_HIDDEN] = {};
+    int8_t l1_weights[NNUE_L1][2 * NNUE_HIDDEN] = {}; // вход: суммы ходящего, потом соперника
+    int32_t l1_bias[NNUE_L1] = {};
+    int8_t out_weights[NNUE_L1] = {};
+    int32_t out_bias = 0;
+
+    // Сеть, которая считает ту же оценку, что и calc_score в режиме NumberAndPotential: первые нейроны первого
+    // слоя - число своих и чужих шашек и дамок (по 8 за фигуру) и продвижение своих и чужих шашек, плотный
+    // слой передаёт их дальше, а выход складывает с весами оценки. Веса шашки и дамки округляются до кратных 4,
+    // выходные веса не больше 127 (дамка до 508, продвижение до 63). Стартовая точка для обучения и сеть
+    // по умолчанию, если файла сети нет
+    explicit nnue_network(const eval_weights &weights = eval_weights())
+    {
+        for (int sq = 0; sq < 32; ++sq)
+        {
+            feature_weights[nnue_feature(0, 0, false, sq)][0] = 8;
+            feature_weights[nnue_feature(0, 0, false, sq)][4] = int16_t(advance_of(0, sq));
+            feature_weights[nnue_feature(0, 1, false, sq)][1] = 8;
+            feature_weights[nnue_feature(0, 1, false, sq)][5] = int16_t(advance_of(1, sq));
+            feature_weights[nnue_feature(0, 0, true, sq)][2] = 8;
+            feature_weights[nnue_feature(0, 1, true, sq)][3] = 8;
+        }
+        for (int i = 0; i < 6; ++i)
+            l1_weights[i][i] = int8_t(1 << NNUE_L1_SHIFT);
+        auto clamp_weight = [](const int w) { return int8_t(min(max(w, -NNUE_CLIP), NNUE_CLIP)); };
+        const int man = clamp_weight(weights.man / 4), queen = clamp_weight(weights.potential_queen / 4);
+        const int advance = clamp_weight(weights.advance * 2);
+        const int8_t out[6] = {int8_t(man), int8_t(-man), int8_t(queen), int8_t(-queen), int8_t(advance),
+                               int8_t(-advance)};
+        memcpy(out_weights, out, sizeof(out));
+    }
+
+    // читает сеть из файла; нет файла или он другого размера - сеть не меняется
+    bool load(const string &path)
+    {
+        ifstream fin(path, ios::binary);
+        char magic[sizeof(NNUE_MAGIC)];
+        if (!fin.read(magic, sizeof(magic)) || memcmp(magic, NNUE_MAGIC, sizeof(magic)) != 0)
+            return false;
+        nnue_network net(*this);
+        auto read = [&fin](void *data, const size_t size) { fin.read(static_cast<char *>(data), streamsize(size)); };
+        read(net.feature_weights, sizeof(net.feature_weights));
+        read(net.feature_bias, sizeof(net.feature_bias));
+        read(net.l1_weights, sizeof(net.l1_weights));
+        read(net.l1_bias, sizeof(net.l1_bias));
+        read(net.out_weights, sizeof(net.out_weights));
+        read(&net.out_bias, sizeof(net.out_bias));
+        if (!fin || fin.peek() != ifstream::traits_type::eof())
+            return false;
+        *this = net;
+        return true;
+    }
+
+    bool save(const string &path) const
+    {
+        ofstream fout(path, ios::binary | ios::trunc);
+        auto write = [&fout](const void *data, const size_t size) {
+            fout.write(static_cast<const char *>(data), streamsize(size));
+        };
+        write(NNUE_MAGIC, sizeof(NNUE_MAGIC));
+        write(feature_weights, sizeof(feature_weights));
+        write(feature_bias, sizeof(feature_bias));
+        write(l1_weights, sizeof(l1_weights));
+        write(l1_bias, sizeof(l1_bias));
+        write(out_weights, sizeof(out_weights));
+        write(&out_bias, sizeof(out_bias));
+        return bool(fout);
+    }
+
+    // аккумулятор позиции целиком: смещения и строки всех фигур
+    void refresh(nnue_accumulator &acc, const Position &pos) const
+    {
+        for (int side = 0; side < 2; ++side)
+            memcpy(acc.side[side], feature_bias, sizeof(feature_bias));
+        for (int color = 0; color < 2; ++color)
+            for (MASK_T m = pos.pieces[color]; m; m &= m - 1)
+                update_piece<true>(acc, color, (pos.kings & (m & -m)) != 0, low_bit(m));
+    }
+
+    // Аккумулятор child позиции после хода turn из аккумулятора parent позиции pos до хода (как make_move):
+    // меняются строки только сходившей и побитых фигур
+    void update(const nnue_accumulator &parent, nnue_accumulator &child, const Position &pos,
+                const bit_move turn) const
+    {
+        child = parent;
+        const MASK_T from = sq_mask(turn.from);
+        const bool color = (pos.pieces[1] & from) != 0;
+        const bool queen = (pos.kings & from) != 0;
+        const bool crowned = (queen || turn.promote || (PROMOTE_ROW[color] & sq_mask(turn.to)));
+        update_piece<false>(child, color, queen, turn.from);
+        update_piece<true>(child, color, crowned, turn.to);
+        for (MASK_T m = turn.caps; m; m &= m - 1)
+            update_piece<false>(child, !color, (pos.kings & (m & -m)) != 0, low_bit(m));
+    }
+
+    // оценка с точки зрения ходящего цвета color в сотых долях шашки
+    int evaluate(const nnue_accumulator &acc, const bool color) const
+    {
+        alignas(32) uint8_t input[2 * NNUE_HIDDEN];
+        nnue_clip(acc.side[color], input);
+        nnue_clip(acc.side[!color], input + NNUE_HIDDEN);
+        int out = out_bias;
+        for (int i = 0; i < NNUE_L1; ++i)
+        {
+            const int sum = (l1_bias[i] + nnue_dot(input, l1_weights[i])) >> NNUE_L1_SHIFT;
+            out += min(max(sum, 0), NNUE_CLIP) * out_weights[i];
+        }
+        return out >> NNUE_OUT_SHIFT;
+    }
+
+  private:
+    template <bool Add> void update_piece(nnue_accumulator &acc, const bool color, const bool queen, const int sq) const
+    {
+        nnue_update_row<Add>(acc.side[0], feature_weights[nnue_feature(0, color, queen, sq)]);
+        nnue_update_row<Add>(acc.side[1], feature_weights[nnue_feature(1, color, queen, sq)]);
+    }
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Bitboard.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// Запись дебютной книги: позиция (ключ с цветом ходящего), позиция после хода и вес хода.
+// Файл книги - BOOK_MAGIC и записи, отсортированные по ключу
+struct book_entry
+{
+    uint64_t key;
+    uint64_t next_key;
+    uint32_t weight;
+    uint32_t reserved = 0;
+
+    bool operator<(const book_entry &other) const
+    {
+        return key < other.key || (key == other.key && next_key < other.next_key);
+    }
+};
+
+const char BOOK_MAGIC[8] = {'C', 'K', 'B', 'O', 'O', 'K', '1', '\0'};
+
+// Дебютная книга, отображённая в память: поиск позиции двоичным поиском по ключу
+class OpeningBook
+{
+  public:
+    explicit OpeningBook(const string &path)
+    {
+        if (file.open(path) && file.size() >= sizeof(BOOK_MAGIC) &&
+            (file.size() - sizeof(BOOK_MAGIC)) % sizeof(book_entry) == 0 &&
+            memcmp(file.data(), BOOK_MAGIC, sizeof(BOOK_MAGIC)) == 0)
+        {
+            entries = reinterpret_cast<const book_entry *>(file.data() + sizeof(BOOK_MAGIC));
+            count = (file.size() - sizeof(BOOK_MAGIC)) / sizeof(book_entry);
+        }
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    // Ход из книги для цвета color: при no_random ход с наибольшим весом, иначе случайный пропорционально весу.
+    // Пустой вектор - позиции нет в книге
+    vector<move_pos> find_turns(Position pos, const bool color, const bool no_random, default_random_engine &rand_eng) const
+    {
+        const uint64_t key = pos.hash(color);
+        const book_entry *first = lower_bound(entries, entries + count, key,
+                                              [](const book_entry &entry, const uint64_t k) { return entry.key < k; });
+        const book_entry *last = first;
+        uint64_t total = 0;
+        while (last != entries + count && last->key == key)
+            total += (last++)->weight;
+        if (first == last || total == 0)
+            return {};
+
+        const book_entry *choice = first;
+        if (no_random)
+        {
+            for (const book_entry *entry = first; entry != last; ++entry)
+                if (entry->weight > choice->weight)
+                    choice = entry;
+        }
+        else
+        {
+            uint64_t pick = uniform_int_distribution<uint64_t>(0, total - 1)(rand_eng);
+            while (pick >= choice->weight)
+                pick -= (choice++)->weight;
+        }
+
+        // ход восстанавливается по позиции после него; если такого хода нет (совпадение ключей), книги нет
+        vector<move_pos> res;
+        for_each_full_turn(pos, color, [&](const Position &next, const vector<bit_move> &series) {
+            if (res.empty() && next.hash(!color) == choice->next_key)
+                for (auto turn : series)
+                    res.push_back(turn.to_move_pos());
+        });
+        return res;
+    }
+
+  private:
+    MappedFile file;
+    const book_entry *entries = nullptr;
+    size_t count = 0;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+
+using namespace std;
+
+// Счётчики поиска для лога. Сборка с -DSEARCH_STATS=0 убирает их: поля пропадают, а методы становятся пустыми,
+// так что вызовы в поиске компилятор выбрасывает
+#ifndef SEARCH_STATS
+    #define SEARCH_STATS 1
+#endif
+
+const int STATS_MAX_PLY = 64; // узлы считаются по расстоянию от корня до этой глубины
+
+template <bool Enabled> struct search_counters
+{
+    static constexpr bool enabled = true;
+
+    size_t expanded = 0;             // узлы, в которых перебирались ходы
+    size_t cutoffs = 0;              // из них закончились отсечением
+    size_t first_cutoffs = 0;        // отсечение дал первый же ход
+    size_t tt_probes = 0;            // обращения к таблице транспозиций
+    size_t tt_hits = 0;              // позиция нашлась в таблице
+    size_t ply_nodes[STATS_MAX_PLY] = {}; // узлы основного поиска на каждом расстоянии от корня
+
+    void clear()
+    {
+        *this = search_counters();
+    }
+
+    // добавляет счётчики другого потока
+    void add(const search_counters &other)
+    {
+        expanded += other.expanded;
+        cutoffs += other.cutoffs;
+        first_cutoffs += other.first_cutoffs;
+        tt_probes += other.tt_probes;
+        tt_hits += other.tt_hits;
+        for (int ply = 0; ply < STATS_MAX_PLY; ++ply)
+            ply_nodes[ply] += other.ply_nodes[ply];
+    }
+
+    void node(const size_t ply)
+    {
+        if (ply < size_t(STATS_MAX_PLY))
+            ++ply_nodes[ply];
+    }
+
+    void probe(const bool hit)
+    {
+        ++tt_probes;
+        tt_hits += hit;
+    }
+
+    void expand()
+    {
+        ++expanded;
+    }
+
+    // отсечение на ходе номер turn_num в порядке перебора
+    void cutoff(const int turn_num)
+    {
+        ++cutoffs;
+        first_cutoffs += (turn_num == 0);
+    }
+
+    // одна строка лога: доля отсечений, доля отсечений первым ходом, попадания в таблицу и ветвление
+    // от каждой глубины к следующей (узлы всех итераций вместе)
+    void write(ostream &out) const
+    {
+        auto percent = [](const size_t part, const size_t whole) { return whole ? 100.0 * part / whole : 0.0; };
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << fixed << setprecision(1);
+        out << "cutoffs " << percent(cutoffs, expanded) << "%, first move cutoffs " << percent(first_cutoffs, cutoffs)
+            << "%, hash hits " << percent(tt_hits, tt_probes) << "%, branching";
+        for (int ply = 0; ply + 1 < STATS_MAX_PLY && ply_nodes[ply + 1]; ++ply)
+            out << " " << double(ply_nodes[ply + 1]) / ply_nodes[ply];
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+template <> struct search_counters<false>
+{
+    static constexpr bool enabled = false;
+
+    void clear() {}
+    void add(const search_counters &) {}
+    void node(size_t) {}
+    void probe(bool) {}
+    void expand() {}
+    void cutoff(int) {}
+    void write(ostream &) const {}
+};
+
+using search_stats = search_counters<SEARCH_STATS != 0>;
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Bitboard.h"
+
+// Тип оценки, сохранённой в таблице: точная, нижняя или верхняя граница
+enum class Bound : uint8_t
+{
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+struct tt_entry
+{
+    uint64_t key = 0;       // полный ключ позиции для проверки совпадения
+    int score = 0;          // оценка позиции
+    bit_move move{-1, -1};  // лучший ход, найденный в позиции
+    int8_t depth = -1;      // оставшаяся глубина, на которой получена оценка
+    Bound bound = Bound::EXACT;
+};
+
+// Таблица транспозиций фиксированного размера, индекс записи - младшие биты ключа.
+// Общая для всех потоков поиска и без блокировок: запись хранится тремя атомарными словами, а вместо ключа
+// хранится ключ XOR данные. Запись, которую другой поток переписал наполовину, не сойдётся с ключом
+// при чтении и будет считаться отсутствующей
+class TTable
+{
+  public:
+    TTable(const size_t size_mb = 16)
+    {
+        size = 1;
+        while (size * 2 * sizeof(tt_slot) <= size_mb * 1024 * 1024)
+            size *= 2;
+        slots.reset(new tt_slot[size]);
+        mask = size - 1;
+    }
+
+    // копирует запись позиции в entry, возвращает false, если её нет в таблице
+    bool probe(const uint64_t key, tt_entry &entry) const
+    {
+        const tt_slot &slot = slots[key & mask];
+        const uint64_t score = slot.score.load(memory_order_relaxed);
+        const uint64_t data = slot.data.load(memory_order_relaxed);
+        if ((slot.check.load(memory_order_relaxed) ^ score ^ data) != key || !data)
+            return false;
+        entry.key = key;
+        entry.score = int(int64_t(score));
+        entry.move = bit_move(int8_t(data), int8_t(data >> 8), MASK_T(data >> 32), ((data >> 26) & 1) != 0);
+        entry.depth = int8_t(data >> 16);
+        entry.bound = Bound(uint8_t(data >> 24) & 3);
+        return true;
+    }
+
+    // сохраняет оценку, не затирая более глубокую оценку той же позиции
+    void store(const uint64_t key, const int depth, const Bound bound, const int score, const bit_move move)
+    {
+        tt_slot &slot = slots[key & mask];
+        tt_entry old;
+        if (probe(key, old) && old.depth > depth)
+            return;
+        const uint64_t score_bits = uint64_t(int64_t(score));
+        // бит 27 всегда 1, чтобы данные пустой ячейки (0) нельзя было спутать с записью;
+        // побитые клетки составного хода - старшие 32 бита
+        const uint64_t data = uint64_t(uint8_t(move.from)) | uint64_t(uint8_t(move.to)) << 8 |
+                              uint64_t(uint8_t(depth)) << 16 | uint64_t(uint8_t(bound)) << 24 |
+                              uint64_t(move.promote) << 26 | uint64_t(1) << 27 | uint64_t(move.caps) << 32;
+        slot.check.store(key ^ score_bits ^ data, memory_order_relaxed);
+        slot.score.store(score_bits, memory_order_relaxed);
+        slot.data.store(data, memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            slots[i].check.store(0, memory_order_relaxed);
+            slots[i].score.store(0, memory_order_relaxed);
+            slots[i].data.store(0, memory_order_relaxed);
+        }
+    }
+
+  private:
+    struct tt_slot
+    {
+        atomic<uint64_t> check{0}; // key ^ score ^ data
+        atomic<uint64_t> score{0}; // оценка со знаком
+        atomic<uint64_t> data{0};  // ход, глубина и тип границы
+    };
+
+    unique_ptr<tt_slot[]> slots;
+    size_t size;
+    size_t mask;
+};
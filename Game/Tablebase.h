@@ -0,0 +1,191 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bitboard.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// Эндшпильные таблицы: для каждой расстановки материала (срез) файл, где на каждую позицию с ходом белых
+// приходится один байт: 0 - ничья, иначе число полуходов до конца партии + 1. Чётное число полуходов -
+// ходящий проигрывает, нечётное - выигрывает. Позиции с ходом чёрных берутся из зеркального среза
+// (доска повёрнута на 180 градусов, цвета поменяны местами)
+const int TB_MAX_PIECES = 8; // больше фигур таблицы не ищутся
+const uint8_t TB_DRAW = 0;
+
+// число сочетаний C(n, k) для n <= 32, k <= 12
+inline size_t binom(const int n, const int k)
+{
+    static const vector<vector<size_t>> table = [] {
+        vector<vector<size_t>> t(33, vector<size_t>(13, 0));
+        for (int i = 0; i <= 32; ++i)
+        {
+            t[i][0] = 1;
+            for (int j = 1; j <= min(i, 12); ++j)
+                t[i][j] = t[i - 1][j - 1] + t[i - 1][j];
+        }
+        return t;
+    }();
+    return (k < 0 || k > 12 || n < k) ? 0 : table[n][k];
+}
+
+// номер множества клеток среди всех множеств того же размера (комбинаторная система счисления)
+inline size_t subset_rank(MASK_T m)
+{
+    size_t res = 0;
+    for (int i = 1; m; m &= m - 1, ++i)
+        res += binom(low_bit(m), i);
+    return res;
+}
+
+// обратное к subset_rank: множество из k клеток по номеру
+inline MASK_T subset_unrank(size_t rank, const int k)
+{
+    MASK_T m = 0;
+    for (int i = k; i >= 1; --i)
+    {
+        int c = i - 1;
+        while (binom(c + 1, i) <= rank)
+            ++c;
+        rank -= binom(c, i);
+        m |= sq_mask(c);
+    }
+    return m;
+}
+
+// поворот доски на 180 градусов: клетка sq переходит в 31 - sq
+inline MASK_T reverse_mask(MASK_T b)
+{
+    b = ((b >> 1) & 0x55555555) | ((b & 0x55555555) << 1);
+    b = ((b >> 2) & 0x33333333) | ((b & 0x33333333) << 2);
+    b = ((b >> 4) & 0x0F0F0F0F) | ((b & 0x0F0F0F0F) << 4);
+    b = ((b >> 8) & 0x00FF00FF) | ((b & 0x00FF00FF) << 8);
+    return (b >> 16) | (b << 16);
+}
+
+// позиция, повёрнутая на 180 градусов с заменой цветов: ход чёрных в ней - то же, что ход белых в исходной.
+// Ключ Зобриста не пересчитывается
+inline Position flip_position(const Position &pos)
+{
+    Position res;
+    res.pieces[0] = reverse_mask(pos.pieces[1]);
+    res.pieces[1] = reverse_mask(pos.pieces[0]);
+    res.kings = reverse_mask(pos.kings);
+    res.count_material();
+    return res;
+}
+
+// Срез таблиц: количество простых шашек и дамок белых и чёрных
+struct tb_material
+{
+    int wm = 0, wk = 0, bm = 0, bk = 0;
+
+    tb_material() = default;
+    tb_material(const int wm, const int wk, const int bm, const int bk) : wm(wm), wk(wk), bm(bm), bk(bk)
+    {
+    }
+    explicit tb_material(const Position &pos)
+        : wm(pop_count(pos.men(0))), wk(pop_count(pos.queens(0))), bm(pop_count(pos.men(1))),
+          bk(pop_count(pos.queens(1)))
+    {
+    }
+
+    int total() const
+    {
+        return wm + wk + bm + bk;
+    }
+
+    tb_material flipped() const
+    {
+        return tb_material(bm, bk, wm, wk);
+    }
+
+    // номер среза для массивов срезов
+    int id() const
+    {
+        return ((wm * 13 + wk) * 13 + bm) * 13 + bk;
+    }
+
+    // число индексов среза (часть из них - невозможные позиции)
+    size_t size() const
+    {
+        return binom(32, wm) * binom(32, wk) * binom(32, bm) * binom(32, bk);
+    }
+
+    string file_name() const
+    {
+        return "tb_" + to_string(wm) + to_string(wk) + to_string(bm) + to_string(bk) + ".bin";
+    }
+
+    // номер позиции с ходом белых в срезе
+    size_t index(const Position &pos) const
+    {
+        size_t res = subset_rank(pos.men(0));
+        res = res * binom(32, wk) + subset_rank(pos.queens(0));
+        res = res * binom(32, bm) + subset_rank(pos.men(1));
+        return res * binom(32, bk) + subset_rank(pos.queens(1));
+    }
+
+    // позиция по номеру; false, если фигуры стоят на одной клетке или простая шашка на поле превращения
+    bool position(size_t idx, Position &pos) const
+    {
+        const MASK_T black_queens = subset_unrank(idx % binom(32, bk), bk);
+        idx /= binom(32, bk);
+        const MASK_T black_men = subset_unrank(idx % binom(32, bm), bm);
+        idx /= binom(32, bm);
+        const MASK_T white_queens = subset_unrank(idx % binom(32, wk), wk);
+        const MASK_T white_men = subset_unrank(idx / binom(32, wk), wm);
+        if (pop_count(white_men | white_queens | black_men | black_queens) != total() ||
+            (white_men & PROMOTE_ROW[0]) || (black_men & PROMOTE_ROW[1]))
+            return false;
+        pos = Position();
+        pos.pieces[0] = white_men | white_queens;
+        pos.pieces[1] = black_men | black_queens;
+        pos.kings = white_queens | black_queens;
+        pos.count_material();
+        return true;
+    }
+};
+
+// Эндшпильные таблицы, отображённые в память. Отсутствующие файлы просто не используются
+class Tablebase
+{
+  public:
+    explicit Tablebase(const string &dir) : files(13 * 13 * 13 * 13)
+    {
+        for (int wm = 0; wm <= TB_MAX_PIECES; ++wm)
+            for (int wk = 0; wm + wk <= TB_MAX_PIECES; ++wk)
+                for (int bm = 0; wm + wk + bm <= TB_MAX_PIECES; ++bm)
+                    for (int bk = 0; wm + wk + bm + bk <= TB_MAX_PIECES; ++bk)
+                    {
+                        const tb_material mat(wm, wk, bm, bk);
+                        unique_ptr<MappedFile> file(new MappedFile());
+                        if (!file->open(dir + mat.file_name()) || file->size() != mat.size())
+                            continue;
+                        max_pieces = max(max_pieces, mat.total());
+                        ++slices;
+                        files[mat.id()] = move(file);
+                    }
+    }
+
+    // -1 - позиции нет в таблицах, иначе значение из таблицы (TB_DRAW или число полуходов до конца + 1)
+    int probe(const Position &pos, const bool color) const
+    {
+        if (pop_count(pos.occupied()) > max_pieces)
+            return -1;
+        const Position white_pos = (color ? flip_position(pos) : pos);
+        const tb_material mat(white_pos);
+        const auto &file = files[mat.id()];
+        if (!file)
+            return -1;
+        return file->data()[mat.index(white_pos)];
+    }
+
+    int max_pieces = 0; // наибольшее число фигур среди загруженных срезов
+    int slices = 0;     // число загруженных срезов
+
+  private:
+    vector<unique_ptr<MappedFile>> files; // по номеру среза
+};
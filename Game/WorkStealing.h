@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Bitboard.h"
+
+using namespace std;
+
+// Двусторонняя очередь задач потока: владелец кладёт и забирает задачи с конца (последние - самые глубокие),
+// остальные потоки крадут с начала (самые крупные задачи). Кольцевой буфер выделяется один раз на поиск
+// и растёт, только если задач стало больше, чем когда-либо раньше
+template <class T> class work_deque
+{
+  public:
+    explicit work_deque(const size_t capacity = 1024) : items(capacity)
+    {
+    }
+
+    void push(const T &item)
+    {
+        lock_guard<mutex> lock(m);
+        if (count == items.size())
+            grow();
+        items[(head + count) % items.size()] = item;
+        ++count;
+    }
+
+    // забирает последнюю задачу, если она подходит под условие
+    template <class Pred> bool pop_if(T &item, Pred pred)
+    {
+        lock_guard<mutex> lock(m);
+        if (!count || !pred(items[(head + count - 1) % items.size()]))
+            return false;
+        item = items[(head + count - 1) % items.size()];
+        --count;
+        return true;
+    }
+
+    // крадёт первую задачу, если она подходит под условие
+    template <class Pred> bool steal_if(T &item, Pred pred)
+    {
+        lock_guard<mutex> lock(m);
+        if (!count || !pred(items[head]))
+            return false;
+        item = items[head];
+        head = (head + 1) % items.size();
+        --count;
+        return true;
+    }
+
+  private:
+    void grow()
+    {
+        vector<T> bigger(items.size() * 2);
+        for (size_t i = 0; i < count; ++i)
+            bigger[i] = items[(head + i) % items.size()];
+        items.swap(bigger);
+        head = 0;
+    }
+
+    mutex m;
+    vector<T> items;
+    size_t head = 0;  // индекс первой задачи
+    size_t count = 0; // число задач
+};
+
+// Точка разделения поиска (Young Brothers Wait): старший ход узла уже просмотрен, остальные ходы
+// просматриваются параллельно с одним и тем же окном (alpha, beta)
+struct split_point
+{
+    split_point *parent;  // точка разделения, внутри задачи которой создана эта (nullptr - поиск из корня)
+    int parent_index;     // номер этой задачи в parent
+    Position pos;         // позиция узла
+    bool color;           // кто ходит
+    size_t depth;         // номер хода узла от корня
+    size_t search_depth;  // глубина итерации
+    bool have_beats;      // ходы узла - взятия (серии целиком)
+    int alpha, beta;      // окно для всех младших ходов
+    move_list turns;        // младшие ходы узла (без первого)
+    int scores[MAX_TURNS];  // оценки ходов по номерам
+    atomic<int> pending;    // сколько задач ещё не закончено
+    atomic<int> cutoff;     // наименьший номер хода, давшего отсечение; задачи с большим номером не нужны
+
+    // задача index этой точки больше не нужна: отсечение младшим ходом или отмена выше по дереву
+    bool aborted(int index) const
+    {
+        for (const split_point *sp = this; sp; index = sp->parent_index, sp = sp->parent)
+        {
+            if (sp->cutoff.load(memory_order_relaxed) < index)
+                return true;
+        }
+        return false;
+    }
+
+    // точка лежит в поддереве задачи точки ancestor
+    bool inside(const split_point *ancestor) const
+    {
+        for (const split_point *sp = this; sp; sp = sp->parent)
+        {
+            if (sp == ancestor)
+                return true;
+        }
+        return false;
+    }
+};
+
+struct split_task
+{
+    split_point *sp;
+    int index; // номер хода в sp->turns
+};
+
+// Общие данные потоков одного поиска: очереди задач и флаг остановки
+struct work_pool
+{
+    explicit work_pool(const int threads)
+    {
+        for (int i = 0; i < threads; ++i)
+            deques.emplace_back(new work_deque<split_task>());
+    }
+
+    vector<unique_ptr<work_deque<split_task>>> deques;
+    atomic<bool> stop_all{false}; // бюджет хода кончился, все потоки бросают работу
+};
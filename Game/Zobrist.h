@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// Ключи Зобриста для хеширования позиций. Генерируются детерминированно (splitmix64 с фиксированным зерном),
+// поэтому хеш позиции одинаков при каждом запуске программы
+struct zobrist_keys
+{
+    uint64_t piece[4][32]; // [тип фигуры][клетка]: 0 - белая шашка, 1 - чёрная шашка, 2 - белая дамка, 3 - чёрная дамка
+    uint64_t side;         // ходят чёрные
+};
+
+constexpr uint64_t splitmix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr zobrist_keys make_zobrist_keys()
+{
+    zobrist_keys keys{};
+    uint64_t state = 20240601;
+    for (int type = 0; type < 4; ++type)
+    {
+        for (int sq = 0; sq < 32; ++sq)
+            keys.piece[type][sq] = splitmix64(state);
+    }
+    keys.side = splitmix64(state);
+    return keys;
+}
+
+constexpr zobrist_keys ZOBRIST = make_zobrist_keys();
@@ -0,0 +1,111 @@
+// Бенчмарк поиска: несколько позиций на фиксированную глубину в один поток, время, узлы и число выделений
+// памяти в куче за поиск. Поиск не должен выделять память: единственное выделение - вектор с ответом.
+// Запуск из корня репозитория (нужен settings.json):
+//   bench [уровень = 8]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "../Game/Logic.h"
+
+// GCC принимает замену operator new / delete на malloc / free за несовпадающие пары
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// счётчик выделений памяти всей программы
+atomic<size_t> allocations{0};
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void *ptr = malloc(size ? size : 1))
+        return ptr;
+    throw bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// позиция после plies случайных ходов от начальной (серия взятий - один ход), seed задаёт партию
+Position random_position(const unsigned seed, const int plies, bool &color)
+{
+    mt19937 rng(seed);
+    Position pos = start_position();
+    color = 0;
+    for (int i = 0; i < plies; ++i)
+    {
+        vector<Position> next;
+        for_each_full_turn(pos, color, [&](const Position &after, const vector<bit_move> &) { next.push_back(after); });
+        if (next.empty())
+            break;
+        pos = next[rng() % next.size()];
+        color = !color;
+    }
+    return pos;
+}
+
+int main(int argc, char *argv[])
+{
+    const int level = (argc > 1 ? atoi(argv[1]) : 8);
+
+    Config config;
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "BotDelayMS", 0);
+    config.set("Bot", "BotMaxNodes", 0);
+    config.set("Bot", "BotThreads", 1);
+    config.set("Bot", "TablebaseDir", string(""));
+    config.set("Bot", "OpeningBook", string(""));
+    config.set("Bot", "EvalWeights", string("")); // узлы сравнимы между запусками только при одних весах
+    Logic logic(&config);
+    logic.Max_depth = level;
+
+    struct bench_position
+    {
+        const char *name;
+        Position pos;
+        bool color;
+    };
+    vector<bench_position> positions = {{"start", start_position(), 0}};
+    for (const int plies : {10, 20, 30})
+    {
+        bench_position bp{plies == 10 ? "opening" : (plies == 20 ? "middle" : "late"), Position(), 0};
+        bp.pos = random_position(unsigned(plies), plies, bp.color);
+        positions.push_back(bp);
+    }
+    Position kings; // дамочный эндшпиль
+    kings.pieces[0] = sq_mask(22) | sq_mask(25) | sq_mask(28) | sq_mask(29);
+    kings.pieces[1] = sq_mask(1) | sq_mask(3) | sq_mask(6) | sq_mask(9);
+    kings.kings = sq_mask(28) | sq_mask(29) | sq_mask(1) | sq_mask(6);
+    kings.compute_key();
+    kings.count_material();
+    positions.push_back({"kings", kings, 0});
+
+    printf("level %d\n", level);
+    printf("%10s %10s %12s %12s %8s\n", "position", "time ms", "nodes", "nodes/sec", "allocs");
+    size_t total_nodes = 0;
+    double total_ms = 0;
+    for (const auto &bp : positions)
+    {
+        const size_t allocs_before = allocations.load();
+        const auto start = chrono::steady_clock::now();
+        const auto turns = logic.find_best_turns(bp.pos, bp.color);
+        const double ms = max(1e-3, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        // выделение под возвращённый вектор ходов не относится к поиску
+        const size_t allocs = allocations.load() - allocs_before - (turns.empty() ? 0 : 1);
+        total_nodes += logic.nodes;
+        total_ms += ms;
+        printf("%10s %10.1f %12zu %12.0f %8zu\n", bp.name, ms, logic.nodes, logic.nodes / ms * 1000, allocs);
+    }
+    printf("%10s %10.1f %12zu %12.0f\n", "total", total_ms, total_nodes, total_nodes / total_ms * 1000);
+    return 0;
+}
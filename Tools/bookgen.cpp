@@ -0,0 +1,240 @@
+// Построение дебютной книги по глубокому поиску и (или) партиям в PDN. Запуск из корня репозитория:
+//   bookgen [полуходов = 6] [уровень поиска = 6, 0 - без поиска] [книга = opening.book] [партии.pdn ...]
+// Поиск: из начальной позиции для каждой стороны книги берутся все ходы соперника и лучшие ходы стороны
+// (все ходы, оценка которых не хуже лучшей больше чем на BOOK_MARGIN, с весом по оценке).
+// PDN: ходы партий в алгебраической записи русских шашек (c3-d4, e3:c5:e7), вес хода растёт с результатом
+// партии для сыгравшей его стороны
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "../Game/Logic.h"
+
+const int BOOK_MARGIN = 20; // насколько ход может быть хуже лучшего, чтобы попасть в книгу
+
+map<pair<uint64_t, uint64_t>, uint64_t> weights; // (позиция, позиция после хода) -> вес хода
+
+struct book_node
+{
+    Position pos;
+    bool color;
+    int plies; // сколько полуходов книги осталось
+};
+
+// оценки ходов позиции, один раз на позицию: ключ позиции после хода и оценка хода
+map<uint64_t, vector<pair<uint64_t, int>>> scored;
+
+const vector<pair<uint64_t, int>> &score_turns(Logic &logic, Position pos, const bool color)
+{
+    auto &res = scored[pos.hash(color)];
+    if (!res.empty())
+        return res;
+    for_each_full_turn(pos, color, [&](const Position &next, const vector<bit_move> &) {
+        move_list replies;
+        gen_turns(next, !color, replies);
+        int score = INF; // у соперника нет ходов
+        if (!replies.empty())
+        {
+            logic.find_best_turns(next, !color);
+            score = -logic.score_reached;
+        }
+        res.emplace_back(next.hash(!color), score);
+    });
+    return res;
+}
+
+// дерево книги для стороны book_color: у неё только ходы из книги, у соперника все ходы
+void build_by_search(Logic &logic, const int plies, const bool book_color)
+{
+    deque<book_node> queue = {book_node{start_position(), 0, plies}};
+    set<uint64_t> seen;
+    while (!queue.empty())
+    {
+        book_node node = queue.front();
+        queue.pop_front();
+        if (!node.plies || !seen.insert(node.pos.hash(node.color)).second)
+            continue;
+        const auto &turns = score_turns(logic, node.pos, node.color);
+        int best = -INF - 1;
+        for (const auto &turn : turns)
+            best = max(best, turn.second);
+        set<uint64_t> book_turns;
+        if (node.color == book_color)
+        {
+            for (const auto &turn : turns)
+            {
+                if (turn.second < best - BOOK_MARGIN)
+                    continue;
+                auto &weight = weights[{node.pos.hash(node.color), turn.first}];
+                weight = max<uint64_t>(weight, 1 + uint64_t(99 * (BOOK_MARGIN - (best - turn.second)) / BOOK_MARGIN));
+                book_turns.insert(turn.first);
+            }
+        }
+        for_each_full_turn(node.pos, node.color, [&](const Position &next, const vector<bit_move> &) {
+            if (node.color != book_color || book_turns.count(next.hash(!node.color)))
+                queue.push_back(book_node{next, !node.color, node.plies - 1});
+        });
+        if (seen.size() % 100 == 0)
+        {
+            printf("side %d: %zu positions\r", int(book_color), seen.size());
+            fflush(stdout);
+        }
+    }
+    printf("side %d: %zu positions\n", int(book_color), seen.size());
+}
+
+// клетки хода в алгебраической записи: a1 - левый нижний угол со стороны белых
+vector<int> parse_squares(const string &token)
+{
+    vector<int> res;
+    for (size_t i = 0; i + 1 < token.size(); ++i)
+    {
+        if (token[i] >= 'a' && token[i] <= 'h' && token[i + 1] >= '1' && token[i + 1] <= '8')
+            res.push_back(square(POS_T(8 - (token[i + 1] - '0')), POS_T(token[i] - 'a')));
+    }
+    return res;
+}
+
+// ходы партии с результатом (1 - победа белых, -1 - чёрных, 0 - ничья или неизвестен); false - ход не разобран
+bool add_game(const vector<string> &moves, const int result, const int plies)
+{
+    Position pos = start_position();
+    bool color = 0;
+    for (int i = 0; i < plies && i < int(moves.size()); ++i)
+    {
+        const vector<int> squares = parse_squares(moves[i]);
+        if (squares.size() < 2 || squares[0] < 0)
+            return false;
+        bool found = false;
+        Position found_next;
+        for_each_full_turn(pos, color, [&](const Position &next, const vector<bit_move> &series) {
+            // либо все клетки серии, либо только начало и конец
+            bool match = (series[0].from == squares[0] && series.back().to == squares.back());
+            if (match && squares.size() > 2)
+            {
+                match = (squares.size() == series.size() + 1);
+                for (size_t j = 0; match && j < series.size(); ++j)
+                    match = (series[j].to == squares[j + 1]);
+            }
+            if (match && !found)
+            {
+                found = true;
+                found_next = next;
+            }
+        });
+        if (!found)
+            return false;
+        const int side_result = (color ? -result : result);
+        weights[{pos.hash(color), found_next.hash(!color)}] += uint64_t(side_result + 1);
+        pos = found_next;
+        color = !color;
+    }
+    return true;
+}
+
+void build_by_pdn(const string &path, const int plies)
+{
+    ifstream fin(path);
+    stringstream buffer;
+    buffer << fin.rdbuf();
+    const string text = buffer.str();
+
+    size_t games = 0, bad = 0;
+    int result = 0;
+    vector<string> moves;
+    auto finish_game = [&] {
+        if (!moves.empty())
+        {
+            ++games;
+            bad += !add_game(moves, result, plies);
+        }
+        moves.clear();
+        result = 0;
+    };
+    for (size_t i = 0; i < text.size();)
+    {
+        const char c = text[i];
+        if (c == '[') // тег, перед тегами начинается новая партия
+        {
+            finish_game();
+            const size_t end = min(text.find(']', i), text.size());
+            const string tag = text.substr(i + 1, end - i - 1);
+            if (tag.compare(0, 6, "Result") == 0)
+            {
+                const size_t quote = tag.find('"');
+                const string value = (quote == string::npos ? "" : tag.substr(quote + 1));
+                result = (value.compare(0, 3, "1-0") == 0 || value.compare(0, 3, "2-0") == 0
+                              ? 1
+                              : (value.compare(0, 3, "0-1") == 0 || value.compare(0, 3, "0-2") == 0 ? -1 : 0));
+            }
+            i = end + 1;
+        }
+        else if (c == '{') // комментарий
+            i = min(text.find('}', i), text.size()) + 1;
+        else if (c == '(') // вариант, может быть вложенным
+        {
+            for (int level = 0; i < text.size(); ++i)
+            {
+                level += (text[i] == '(') - (text[i] == ')');
+                if (!level)
+                    break;
+            }
+            ++i;
+        }
+        else if (isspace((unsigned char)c))
+            ++i;
+        else
+        {
+            size_t end = i;
+            while (end < text.size() && !isspace((unsigned char)text[end]) && !strchr("[{(", text[end]))
+                ++end;
+            string token = text.substr(i, end - i);
+            i = end;
+            token.erase(0, token.find_first_not_of("0123456789.")); // номер хода
+            if (!parse_squares(token).empty())
+                moves.push_back(token);
+        }
+    }
+    finish_game();
+    printf("%s: %zu games, %zu with unknown moves\n", path.c_str(), games, bad);
+}
+
+int main(int argc, char *argv[])
+{
+    const int plies = (argc > 1 ? atoi(argv[1]) : 6);
+    const int level = (argc > 2 ? atoi(argv[2]) : 6);
+    const string path = (argc > 3 ? argv[3] : "opening.book");
+
+    if (level > 0)
+    {
+        Config config;
+        config.set("Bot", "OpeningBook", ""); // книга строится, а не используется
+        config.set("Bot", "NoRandom", true);
+        config.set("Bot", "BotDelayMS", 0);
+        config.set("Bot", "BotMaxNodes", 0);
+        Logic logic(&config);
+        logic.Max_depth = level;
+        build_by_search(logic, plies, 0);
+        build_by_search(logic, plies, 1);
+    }
+    for (int i = 4; i < argc; ++i)
+        build_by_pdn(argv[i], plies);
+
+    vector<book_entry> entries;
+    for (const auto &item : weights)
+    {
+        if (item.second) // ходы только проигравших сторон не берём
+            entries.push_back(book_entry{item.first.first, item.first.second, uint32_t(min<uint64_t>(item.second, UINT32_MAX))});
+    }
+    ofstream fout(path, ios::binary);
+    fout.write(BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    fout.write(reinterpret_cast<const char *>(entries.data()), streamsize(entries.size() * sizeof(book_entry)));
+    printf("%s: %zu moves\n", path.c_str(), entries.size());
+    return 0;
+}
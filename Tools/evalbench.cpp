@@ -0,0 +1,125 @@
+// Бенчмарк оценки: оценок в секунду у оценки calc_score (NumberAndPotential) и у нейросети из Nnue.h - по готовому
+// аккумулятору, с аккумулятором, обновлённым на один ход, как в поиске, и с аккумулятором, посчитанным заново.
+// Позиции берутся из случайных партий. Проверяет, что обновлённый аккумулятор совпадает с посчитанным заново,
+// и считает позиции, где сеть и calc_score дают одно и то же (сеть по умолчанию повторяет NumberAndPotential).
+// Потом ищет начальную позицию на уровень с обеими оценками. Запуск из корня репозитория:
+//   evalbench [партий = 200] [повторов = 50] [уровень = 8] [файл сети = NeuralNetwork из settings.json]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "../Game/Logic.h"
+
+// позиция, ходящий цвет и случайный ход из неё
+struct eval_sample
+{
+    Position pos;
+    bool color;
+    bit_move turn;
+};
+
+vector<eval_sample> random_positions(const int games)
+{
+    vector<eval_sample> res;
+    for (int game = 0; game < games; ++game)
+    {
+        mt19937 rng(static_cast<unsigned>(game));
+        Position pos = start_position();
+        bool color = 0;
+        for (int ply = 0; ply < 200; ++ply, color = !color)
+        {
+            move_list turns;
+            gen_turns(pos, color, turns);
+            if (turns.empty())
+                break;
+            const bit_move turn = turns[rng() % turns.size()];
+            res.push_back({pos, color, turn});
+            pos = make_turn(pos, turn);
+        }
+    }
+    return res;
+}
+
+int main(int argc, char *argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 200);
+    const int rounds = (argc > 2 ? atoi(argv[2]) : 50);
+    const int level = (argc > 3 ? atoi(argv[3]) : 8);
+
+    Config config;
+    const string weights_path = config("Bot", "EvalWeights");
+    const eval_weights weights = (weights_path.empty() ? eval_weights() : load_eval_weights(project_path + weights_path));
+    string network_path = config("Bot", "NeuralNetwork");
+    if (argc > 4)
+        network_path = argv[4];
+    auto net = make_shared<nnue_network>(weights);
+    const bool loaded = (!network_path.empty() && net->load(project_path + network_path));
+    printf("network %s, kernels %s\n", loaded ? network_path.c_str() : "from evaluation weights", NNUE_SIMD_NAME);
+
+    const vector<eval_sample> samples = random_positions(games);
+    vector<nnue_accumulator> accs(samples.size());
+    size_t same_score = 0, bad_update = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const eval_sample &s = samples[i];
+        net->refresh(accs[i], s.pos);
+        same_score += (net->evaluate(accs[i], s.color) == material_score<true>(s.pos, s.color, weights));
+        nnue_accumulator updated, fresh;
+        net->update(accs[i], updated, s.pos, s.turn);
+        net->refresh(fresh, make_turn(s.pos, s.turn));
+        bad_update += (memcmp(&updated, &fresh, sizeof(fresh)) != 0);
+    }
+    printf("%zu positions: network score equals calc_score in %zu, bad incremental updates %zu\n", samples.size(),
+           same_score, bad_update);
+
+    // сумма оценок печатается, чтобы компилятор не выбросил вычисления
+    long long sink = 0;
+    double base_rate = 0;
+    auto measure = [&](const char *name, auto eval) {
+        const auto start = chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+            for (size_t i = 0; i < samples.size(); ++i)
+                sink += eval(i);
+        const double sec = max(1e-9, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        const double rate = double(samples.size()) * rounds / sec;
+        if (base_rate == 0)
+            base_rate = rate;
+        printf("%-28s %8.1f M evals/s  %6.2fx\n", name, rate / 1e6, rate / base_rate);
+    };
+    measure("calc_score", [&](const size_t i) { return material_score<true>(samples[i].pos, samples[i].color, weights); });
+    measure("network", [&](const size_t i) { return net->evaluate(accs[i], samples[i].color); });
+    measure("network + update", [&](const size_t i) {
+        nnue_accumulator child;
+        net->update(accs[i], child, samples[i].pos, samples[i].turn);
+        return net->evaluate(child, !samples[i].color);
+    });
+    measure("network + refresh", [&](const size_t i) {
+        nnue_accumulator acc;
+        net->refresh(acc, samples[i].pos);
+        return net->evaluate(acc, samples[i].color);
+    });
+    printf("checksum %lld\n", sink);
+
+    // в поиске: узлы в секунду с каждой оценкой
+    config.set("Bot", "BotThreads", 1);
+    config.set("Bot", "BotPonder", false);
+    config.set("Bot", "BotDelayMS", 0);
+    config.set("Bot", "BotMaxNodes", 0);
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "OpeningBook", string(""));
+    config.set("Bot", "TablebaseDir", string(""));
+    config.set("Bot", "NeuralNetwork", network_path);
+    for (const string scoring : {"NumberAndPotential", "NeuralNetwork"})
+    {
+        config.set("Bot", "BotScoringType", scoring);
+        Logic bot(&config);
+        bot.Max_depth = level;
+        const auto start = chrono::steady_clock::now();
+        bot.find_best_turns(start_position(), 0);
+        const double sec = max(1e-9, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        printf("search level %d, %-18s %.3f s, %zu nodes, %.0f nodes/s, score %d\n", level, scoring.c_str(), sec,
+               bot.nodes, double(bot.nodes) / sec, bot.score_reached);
+    }
+    return 0;
+}
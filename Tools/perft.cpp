@@ -0,0 +1,203 @@
+// Perft: число позиций на глубине N по генератору ходов поиска (серия взятий - один ход), для проверки
+// генератора на известных числах и замера его скорости. Запуск:
+//   perft [глубина = 7] [потоков = 1] [хеш МБ = 0] [divide] [позиция = начальная]
+// Позиция в записи FEN из PDN с алгебраическими клетками, K - дамка: W:Wc3,e3,Kd4:Bb6,f6 (W/B - кто ходит).
+// divide печатает число позиций после каждого хода корня. Ходы корня делятся между потоками
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../Game/Bitboard.h"
+
+// Таблица уже посчитанных поддеревьев: ключ позиции вместе с глубиной и число позиций. Без блокировок,
+// как таблица транспозиций: запись хранит ключ XOR число, и наполовину переписанная запись не сойдётся с ключом
+class perft_hash
+{
+  public:
+    explicit perft_hash(const size_t size_mb)
+    {
+        size = 0;
+        if (!size_mb)
+            return;
+        size = 1;
+        while (size * 2 * sizeof(slot) <= size_mb * 1024 * 1024)
+            size *= 2;
+        slots.reset(new slot[size]);
+    }
+
+    bool probe(const uint64_t key, uint64_t &count) const
+    {
+        if (!size)
+            return false;
+        const slot &s = slots[key & (size - 1)];
+        count = s.count.load(memory_order_relaxed);
+        return (s.check.load(memory_order_relaxed) ^ count) == key;
+    }
+
+    void store(const uint64_t key, const uint64_t count)
+    {
+        if (!size)
+            return;
+        slot &s = slots[key & (size - 1)];
+        s.check.store(key ^ count, memory_order_relaxed);
+        s.count.store(count, memory_order_relaxed);
+    }
+
+  private:
+    struct slot
+    {
+        atomic<uint64_t> check{0};
+        atomic<uint64_t> count{0};
+    };
+
+    unique_ptr<slot[]> slots;
+    size_t size;
+};
+
+// ключ поддерева: позиция, кто ходит и оставшаяся глубина
+uint64_t perft_key(const Position &pos, const bool color, const int depth)
+{
+    return pos.hash(color) ^ (uint64_t(depth) * 0x9E3779B97F4A7C15ull);
+}
+
+uint64_t perft(Position &pos, const bool color, const int depth, perft_hash &hash)
+{
+    move_list turns;
+    gen_turns(pos, color, turns);
+    if (depth == 1)
+        return turns.size();
+    uint64_t count;
+    const uint64_t key = perft_key(pos, color, depth);
+    if (hash.probe(key, count))
+        return count;
+    count = 0;
+    for (auto turn : turns)
+    {
+        undo_rec undo;
+        make_move(pos, turn, undo);
+        count += perft(pos, !color, depth - 1, hash);
+        unmake_move(pos, turn, undo);
+    }
+    hash.store(key, count);
+    return count;
+}
+
+string square_name(const int sq)
+{
+    return string(1, char('a' + sq_y(sq))) + char('0' + 8 - sq_x(sq));
+}
+
+// ход в алгебраической записи: c3-d4 или все клетки серии через двоеточие
+string turn_name(const Position &pos, const bit_move turn)
+{
+    if (!turn.caps)
+        return square_name(turn.from) + "-" + square_name(turn.to);
+    string res = square_name(turn.from);
+    for (auto hop : turn_hops(pos, turn))
+        res += ":" + square_name(hop.to);
+    return res;
+}
+
+// разбирает позицию FEN, false - запись не разобрана
+bool parse_fen(const string &fen, Position &pos, bool &color)
+{
+    pos = Position();
+    if (fen.empty() || (fen[0] != 'W' && fen[0] != 'B'))
+        return false;
+    color = (fen[0] == 'B');
+    bool side = 0;
+    bool queen = false;
+    for (size_t i = 1; i < fen.size(); ++i)
+    {
+        const char c = fen[i];
+        if (c == ':' && i + 1 < fen.size() && (fen[i + 1] == 'W' || fen[i + 1] == 'B'))
+            side = (fen[++i] == 'B');
+        else if (c == 'K')
+            queen = true;
+        else if (c >= 'a' && c <= 'h' && i + 1 < fen.size() && fen[i + 1] >= '1' && fen[i + 1] <= '8')
+        {
+            const int sq = square(POS_T(8 - (fen[i + 1] - '0')), POS_T(c - 'a'));
+            if (sq < 0)
+                return false;
+            pos.pieces[side] |= sq_mask(sq);
+            if (queen)
+                pos.kings |= sq_mask(sq);
+            queen = false;
+            ++i;
+        }
+    }
+    pos.compute_key();
+    pos.count_material();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int depth = 7, threads = 1;
+    size_t hash_mb = 0;
+    bool divide = false;
+    Position pos = start_position();
+    bool color = 0;
+    int number = 0; // сколько числовых аргументов уже разобрано
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        if (arg == "divide")
+            divide = true;
+        else if (strchr(argv[i], ':'))
+        {
+            if (!parse_fen(arg, pos, color))
+            {
+                printf("bad position: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (number == 0)
+            depth = max(1, atoi(argv[i])), ++number;
+        else if (number == 1)
+            threads = max(1, atoi(argv[i])), ++number;
+        else
+            hash_mb = size_t(max(0, atoi(argv[i]))), ++number;
+    }
+    perft_hash hash(hash_mb);
+    printf("depth %d, threads %d, hash %zu MB\n", depth, threads, hash_mb);
+
+    // ходы корня разбирают потоки по одному, у каждого своя копия позиции
+    move_list root;
+    gen_turns(pos, color, root);
+    vector<uint64_t> counts(root.size());
+    atomic<size_t> next{0};
+    const auto start = chrono::steady_clock::now();
+    auto worker = [&] {
+        Position local = pos;
+        for (size_t i = next++; i < root.size(); i = next++)
+        {
+            undo_rec undo;
+            make_move(local, root[i], undo);
+            counts[i] = (depth == 1 ? 1 : perft(local, !color, depth - 1, hash));
+            unmake_move(local, root[i], undo);
+        }
+    };
+    vector<thread> workers;
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers)
+        w.join();
+    const double sec = max(1e-6, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < root.size(); ++i)
+    {
+        total += counts[i];
+        if (divide)
+            printf("%-24s %llu\n", turn_name(pos, root[i]).c_str(), (unsigned long long)counts[i]);
+    }
+    printf("nodes %llu, time %.3f s, nodes/sec %.0f\n", (unsigned long long)total, sec, total / sec);
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Отчёт о масштабировании параллельного поиска: один и тот же поиск на фиксированную глубину
+// с 1, 2, 4, ... потоками. Запуск из корня репозитория (нужен settings.json):
+//   scaling [уровень = 8] [максимум потоков = 64] [LazySMP | YBWC = YBWC]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Game/Logic.h"
+
+int main(int argc, char *argv[])
+{
+    const int level = (argc > 1 ? atoi(argv[1]) : 8);
+    const int max_threads = (argc > 2 ? atoi(argv[2]) : 64);
+    const string mode = (argc > 3 ? argv[3] : "YBWC");
+
+    Config config;
+    config.set("Bot", "BotParallelMode", mode);
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "BotDelayMS", 0);
+    config.set("Bot", "BotMaxNodes", 0);
+    printf("%s, level %d, hardware threads %u\n", mode.c_str(), level, thread::hardware_concurrency());
+    printf("%8s %10s %12s %12s %8s %6s\n", "threads", "time ms", "nodes", "nodes/sec", "speedup", "move");
+
+    double base_ms = 0;
+    vector<move_pos> base_turns;
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        config.set("Bot", "BotThreads", threads);
+        Logic logic(&config);
+        logic.Max_depth = level;
+        const auto start = chrono::steady_clock::now();
+        const auto turns = logic.find_best_turns(start_position(), 0);
+        const double ms = max(1e-3, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        size_t nodes = 0;
+        for (auto thread_nodes : logic.thread_nodes)
+            nodes += thread_nodes;
+        if (threads == 1)
+        {
+            base_ms = ms;
+            base_turns = turns;
+        }
+        // в детерминированном режиме ход обязан совпадать с однопоточным
+        printf("%8d %10.1f %12zu %12.0f %8.2f %6s\n", threads, ms, nodes, nodes / ms * 1000, base_ms / ms,
+               turns == base_turns ? "same" : "diff");
+    }
+    return 0;
+}
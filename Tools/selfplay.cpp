@@ -0,0 +1,38 @@
+// Партии бота против бота без окна (Match): настройки ботов из settings.json, уровни сторон -
+// WhiteBotLevel и BlackBotLevel, если не заданы аргументами. Итоги партий пишутся в selfplay.log, log.txt игры
+// не трогается. Запуск из корня репозитория:
+//   selfplay [партий = 10] [уровень белых] [уровень чёрных]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../Game/Match.h"
+
+int main(int argc, char *argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 10);
+
+    Config config;
+    config.set("Bot", "BotPonder", false);
+    Logic white(&config), black(&config);
+    white.Max_depth = (argc > 2 ? atoi(argv[2]) : int(config("Bot", "WhiteBotLevel")));
+    black.Max_depth = (argc > 3 ? atoi(argv[3]) : int(config("Bot", "BlackBotLevel")));
+    Logger log(project_path + "selfplay.log");
+    Match match(&white, &black, config("Game", "MaxNumTurns"), &log);
+    printf("white level %d, black level %d, %d games\n", white.Max_depth, black.Max_depth, games);
+
+    int results[3] = {0, 0, 0}; // ничьи, победы белых, победы чёрных
+    const auto start = chrono::steady_clock::now();
+    for (int game = 1; game <= games; ++game)
+    {
+        const int res = match.play();
+        ++results[res];
+        printf("game %d: %s in %d moves\n", game, res == 0 ? "draw" : (res == 1 ? "white won" : "black won"),
+               match.turn_num);
+        fflush(stdout);
+    }
+    const double sec = max(1e-6, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    printf("white %d, black %d, draws %d, %.1f s, %.0f games per hour\n", results[1], results[2], results[0], sec,
+           games / sec * 3600);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Генератор эндшпильных таблиц ретроградным анализом. Запуск из корня репозитория:
+//   tbgen [число фигур = 4] [потоков = по числу ядер] [папка = Tablebases/]
+// Срезы считаются от меньшего числа фигур к большему, а при равном - от меньшего числа простых шашек,
+// так что все позиции после взятия или превращения уже посчитаны. Срезы одной группы не зависят друг
+// от друга и считаются параллельно
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "../Game/Tablebase.h"
+
+const uint8_t INVALID = 255; // невозможная позиция, пока идёт счёт
+
+vector<vector<uint8_t>> tables(13 * 13 * 13 * 13); // посчитанные срезы по номеру
+mutex print_mutex;
+
+// значение позиции после хода белых (ходят чёрные) с точки зрения чёрных
+uint8_t value_after(const Position &next)
+{
+    if (!next.pieces[1])
+        return 1; // у чёрных не осталось фигур: проигрыш без ходов
+    const Position white_pos = flip_position(next);
+    const tb_material mat(white_pos);
+    return tables[mat.id()][mat.index(white_pos)];
+}
+
+// Счёт среза вместе с зеркальным (ходы одного приводят в другой). На проходе k находятся позиции, которые
+// решаются ровно за k полуходов: выигрыш, если есть ход в проигрыш соперника не дальше k - 1 полуходов,
+// проигрыш, если все ходы ведут в выигрыш соперника не дальше k - 1 полуходов. Что не решилось - ничья
+void solve(const tb_material &mat, const string &dir)
+{
+    const auto start = chrono::steady_clock::now();
+    vector<tb_material> mats = {mat};
+    if (mat.flipped().id() != mat.id())
+        mats.push_back(mat.flipped());
+    for (const auto &m : mats)
+    {
+        auto &table = tables[m.id()];
+        table.assign(m.size(), 0);
+        Position pos;
+        for (size_t i = 0; i < table.size(); ++i)
+            if (!m.position(i, pos))
+                table[i] = INVALID;
+    }
+
+    int max_external = 0; // наибольшее значение позиций других срезов, встреченных после хода
+    int plies = 0;
+    for (int k = 0; k < INVALID - 1; ++k)
+    {
+        bool changed = false;
+        for (const auto &m : mats)
+        {
+            auto &table = tables[m.id()];
+            for (size_t i = 0; i < table.size(); ++i)
+            {
+                if (table[i])
+                    continue;
+                Position pos;
+                m.position(i, pos);
+                bool any_turn = false, to_loss = false, all_wins = true;
+                for_each_full_turn(pos, 0, [&](const Position &next, const vector<bit_move> &) {
+                    any_turn = true;
+                    const uint8_t value = value_after(next);
+                    const int next_id = tb_material(flip_position(next)).id();
+                    if (next_id != m.id() && next_id != m.flipped().id()) // в том числе у чёрных не осталось фигур
+                        max_external = max(max_external, int(value));
+                    if (value == 0 || value > k) // ничья или ещё не решённая позиция
+                        all_wins = false;
+                    else if ((value - 1) % 2 == 0)
+                        to_loss = true;
+                });
+                if ((!any_turn && k == 0) || (k % 2 == 1 && to_loss) || (k % 2 == 0 && any_turn && all_wins && !to_loss))
+                {
+                    table[i] = uint8_t(k + 1);
+                    changed = true;
+                    plies = k;
+                }
+            }
+        }
+        if (!changed && k >= max_external) // дальше новых решений быть не может
+            break;
+    }
+
+    for (const auto &m : mats)
+    {
+        auto &table = tables[m.id()];
+        size_t wins = 0, losses = 0, draws = 0;
+        for (auto &value : table)
+        {
+            if (value == INVALID)
+                value = TB_DRAW;
+            else if (value == TB_DRAW)
+                ++draws;
+            else
+                ++((value - 1) % 2 ? wins : losses);
+        }
+        ofstream fout(dir + m.file_name(), ios::binary);
+        fout.write(reinterpret_cast<const char *>(table.data()), streamsize(table.size()));
+        lock_guard<mutex> lock(print_mutex);
+        printf("%s: %zu wins, %zu losses, %zu draws, longest %d plies, %.1f s\n", m.file_name().c_str(), wins, losses,
+               draws, plies, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int max_pieces = min(argc > 1 ? atoi(argv[1]) : 4, TB_MAX_PIECES);
+    const int threads = max(1, argc > 2 ? atoi(argv[2]) : int(thread::hardware_concurrency()));
+    const string dir = (argc > 3 ? argv[3] : "Tablebases/");
+    filesystem::create_directories(dir);
+
+    // группы срезов по (число фигур, число простых шашек); в группе по одному срезу из зеркальной пары
+    vector<vector<tb_material>> groups;
+    for (int total = 2; total <= max_pieces; ++total)
+        for (int men = 0; men <= total; ++men)
+        {
+            groups.emplace_back();
+            for (int wm = 0; wm <= men; ++wm)
+                for (int wk = 0; wm + wk <= total; ++wk)
+                {
+                    const int bm = men - wm, bk = total - men - wk;
+                    const tb_material mat(wm, wk, bm, bk);
+                    if (bk >= 0 && wm + wk > 0 && bm + bk > 0 && mat.id() <= mat.flipped().id())
+                        groups.back().push_back(mat);
+                }
+        }
+
+    const auto start = chrono::steady_clock::now();
+    for (const auto &group : groups)
+    {
+        atomic<size_t> next(0);
+        vector<thread> workers;
+        for (int i = 0; i < threads; ++i)
+            workers.emplace_back([&] {
+                for (size_t j; (j = next++) < group.size();)
+                    solve(group[j], dir);
+            });
+        for (auto &worker : workers)
+            worker.join();
+    }
+    printf("done in %.1f s\n", chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    return 0;
+}
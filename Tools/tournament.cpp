@@ -0,0 +1,231 @@
+// Турнир двух настроек бота: партии без окна (Match) идут параллельно на всех ядрах, каждая из сбалансированных
+// дебютных позиций играется дважды со сменой цвета, ничья - по MaxNumTurns из settings.json. Печатает разницу
+// Эло с 95% доверительным интервалом и останавливается досрочно по SPRT. Запуск из корня репозитория:
+//   tournament [партий = 1000] [потоков = 0 - по числу ядер] [бот A] [бот B] [elo0 = 0] [elo1 = 10]
+// Бот задаётся через запятую: level=6,scoring=NumberAndPotential,opt=O1,time=0,nodes=0
+// (time - BotDelayMS, nodes - BotMaxNodes, weights=файл - EvalWeights, network=файл - NeuralNetwork);
+// не заданное берётся из settings.json, уровень - WhiteBotLevel
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "../Game/Match.h"
+
+const int BALLOT_PLIES = 3;      // длина дебюта в ходах (серия взятий - один ход)
+const int BALLOT_LEVEL = 5;      // уровень поиска, которым проверяется баланс дебюта
+const int BALLOT_MARGIN = 40;    // дебют сбалансирован, если оценка по модулю не больше этой
+const double SPRT_ALPHA = 0.05;  // вероятность принять улучшение, которого нет
+const double SPRT_BETA = 0.05;   // вероятность отвергнуть настоящее улучшение
+const int SPRT_MIN_GAMES = 20;   // раньше нормальное приближение слишком грубое, SPRT не останавливает турнир
+
+struct engine_spec
+{
+    string name;
+    Config config;
+    int level;
+};
+
+// разбирает "level=6,scoring=...,opt=...,time=...,nodes=...,weights=...,network=..." поверх настроек из settings.json
+engine_spec parse_engine(const string &name, const string &text)
+{
+    engine_spec spec{name, Config(), 0};
+    spec.level = spec.config("Bot", "WhiteBotLevel");
+    spec.config.set("Bot", "BotThreads", 1); // параллельны партии, а не поиск
+    spec.config.set("Bot", "BotPonder", false);
+    spec.config.set("Bot", "OpeningBook", string("")); // дебют задаёт турнир
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ','))
+    {
+        const size_t eq = item.find('=');
+        if (eq == string::npos)
+            continue;
+        const string key = item.substr(0, eq), value = item.substr(eq + 1);
+        if (key == "level")
+            spec.level = atoi(value.c_str());
+        else if (key == "scoring")
+            spec.config.set("Bot", "BotScoringType", value);
+        else if (key == "opt")
+            spec.config.set("Bot", "Optimization", value);
+        else if (key == "time")
+            spec.config.set("Bot", "BotDelayMS", atoi(value.c_str()));
+        else if (key == "nodes")
+            spec.config.set("Bot", "BotMaxNodes", atoi(value.c_str()));
+        else if (key == "weights")
+            spec.config.set("Bot", "EvalWeights", value);
+        else if (key == "network")
+            spec.config.set("Bot", "NeuralNetwork", value);
+    }
+    return spec;
+}
+
+struct ballot
+{
+    Position pos;
+    bool color;
+};
+
+// все дебюты длиной BALLOT_PLIES, которые поиск считает равными, в случайном, но воспроизводимом порядке
+vector<ballot> make_ballots()
+{
+    vector<ballot> all{{start_position(), 0}};
+    for (int ply = 0; ply < BALLOT_PLIES; ++ply)
+    {
+        vector<ballot> next;
+        vector<uint64_t> seen;
+        for (const auto &b : all)
+        {
+            move_list turns;
+            gen_turns(b.pos, b.color, turns);
+            for (auto turn : turns)
+            {
+                const Position pos = make_turn(b.pos, turn);
+                const uint64_t key = pos.hash(!b.color);
+                if (find(seen.begin(), seen.end(), key) != seen.end())
+                    continue;
+                seen.push_back(key);
+                next.push_back({pos, !b.color});
+            }
+        }
+        all.swap(next);
+    }
+    Config config;
+    config.set("Bot", "NoRandom", true);
+    config.set("Bot", "BotDelayMS", 0);
+    config.set("Bot", "BotMaxNodes", 0);
+    config.set("Bot", "BotThreads", 1);
+    config.set("Bot", "OpeningBook", string(""));
+    Logic judge(&config);
+    judge.Max_depth = BALLOT_LEVEL;
+    vector<ballot> res;
+    for (const auto &b : all)
+    {
+        judge.find_best_turns(b.pos, b.color);
+        if (abs(judge.score_reached) <= BALLOT_MARGIN)
+            res.push_back(b);
+    }
+    shuffle(res.begin(), res.end(), mt19937(1));
+    return res;
+}
+
+// Итог с точки зрения бота A
+struct tally
+{
+    int wins = 0, losses = 0, draws = 0;
+
+    int games() const
+    {
+        return wins + losses + draws;
+    }
+
+    double score() const
+    {
+        return (wins + 0.5 * draws) / max(1, games());
+    }
+
+    // дисперсия очков одной партии
+    double variance() const
+    {
+        const double s = score();
+        return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / max(1, games());
+    }
+};
+
+double elo_from_score(const double s)
+{
+    const double clamped = min(max(s, 1e-6), 1 - 1e-6);
+    return -400 * log10(1 / clamped - 1);
+}
+
+double score_from_elo(const double elo)
+{
+    return 1 / (1 + pow(10, -elo / 400));
+}
+
+// логарифм отношения правдоподобия гипотез elo1 и elo0 в нормальном приближении
+double sprt_llr(const tally &t, const double elo0, const double elo1)
+{
+    const double var = t.variance();
+    if (t.games() == 0 || var <= 0)
+        return 0;
+    const double s0 = score_from_elo(elo0), s1 = score_from_elo(elo1);
+    return t.games() * (s1 - s0) * (2 * t.score() - s0 - s1) / (2 * var);
+}
+
+int main(int argc, char *argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 1000);
+    int threads = (argc > 2 ? atoi(argv[2]) : 0);
+    if (threads <= 0)
+        threads = max(1, int(thread::hardware_concurrency()));
+    const engine_spec engines[2] = {parse_engine("A", argc > 3 ? argv[3] : ""),
+                                    parse_engine("B", argc > 4 ? argv[4] : "")};
+    const double elo0 = (argc > 5 ? atof(argv[5]) : 0), elo1 = (argc > 6 ? atof(argv[6]) : 10);
+    const double lower = log(SPRT_BETA / (1 - SPRT_ALPHA)), upper = log((1 - SPRT_BETA) / SPRT_ALPHA);
+    const int max_turns = engines[0].config("Game", "MaxNumTurns");
+
+    const vector<ballot> ballots = make_ballots();
+    printf("A level %d, B level %d, %d games on %d threads, %zu ballots, SPRT elo0 %.1f elo1 %.1f\n",
+           engines[0].level, engines[1].level, games, threads, ballots.size(), elo0, elo1);
+    if (ballots.empty())
+        return 1;
+
+    mutex result_mutex;
+    tally total;
+    atomic<int> next_game{0};
+    atomic<bool> stop{false};
+    string verdict = "no SPRT decision";
+    auto report = [&] {
+        const double s = total.score(), error = 1.96 * sqrt(total.variance() / max(1, total.games()));
+        const double elo = elo_from_score(s);
+        printf("games %d: +%d -%d =%d, elo %.1f +%.1f -%.1f, LLR %.2f (%.2f, %.2f)\n", total.games(), total.wins,
+               total.losses, total.draws, elo, elo_from_score(s + error) - elo, elo - elo_from_score(s - error),
+               sprt_llr(total, elo0, elo1), lower, upper);
+        fflush(stdout);
+    };
+
+    // партия 2i - дебют i, A белыми; партия 2i + 1 - тот же дебют, A чёрными
+    auto worker = [&] {
+        Config config_a = engines[0].config, config_b = engines[1].config;
+        Logic bot_a(&config_a), bot_b(&config_b);
+        bot_a.Max_depth = engines[0].level;
+        bot_b.Max_depth = engines[1].level;
+        for (int game = next_game++; game < games && !stop; game = next_game++)
+        {
+            const ballot &b = ballots[size_t(game / 2) % ballots.size()];
+            const bool a_white = (game % 2 == 0);
+            Match match(a_white ? &bot_a : &bot_b, a_white ? &bot_b : &bot_a, max_turns);
+            const int res = match.play(b.pos, b.color);
+
+            lock_guard<mutex> lock(result_mutex);
+            if (res == 0)
+                ++total.draws;
+            else if ((res == 1) == a_white)
+                ++total.wins;
+            else
+                ++total.losses;
+            const double llr = sprt_llr(total, elo0, elo1);
+            if (!stop && total.games() >= SPRT_MIN_GAMES && (llr >= upper || llr <= lower))
+            {
+                verdict = (llr >= upper ? "H1 accepted: A is stronger by elo1" : "H0 accepted: A is not stronger");
+                stop = true;
+            }
+            if (total.games() % 10 == 0)
+                report();
+        }
+    };
+    vector<thread> workers;
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers)
+        w.join();
+    report();
+    printf("%s\n", verdict.c_str());
+    return 0;
+}
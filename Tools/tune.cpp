@@ -0,0 +1,242 @@
+// Подбор весов оценки методом Texel: бот играет партии сам с собой (Match) со случайных дебютов, тихие позиции
+// партий вместе с результатом партии становятся выборкой, а веса подбираются градиентным спуском так, чтобы
+// сигмоида оценки предсказывала результат. Шашка остаётся равной 100, подбираются дамка (NumberOnly),
+// дамка и продвижение (NumberAndPotential). Запуск из корня репозитория:
+//   tune [партий = 1000] [уровень = 4] [потоков = 0 - по числу ядер] [итераций = 2000] [файл = weights_tuned.json]
+// Начальные веса - из файла настройки EvalWeights. Бот читает подобранные веса, только если этот файл указан
+// в EvalWeights, поэтому по умолчанию они пишутся в файл, которого игра не читает
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "../Game/Match.h"
+
+const int OPENING_PLIES = 8;     // случайные ходы в начале каждой партии, их позиции в выборку не попадают
+const double LEARNING_RATE = 1.0; // шаг Adam в сотых долях шашки
+
+// Позиция выборки: разности белых и чёрных, из которых складывается оценка, и результат партии для белых
+struct tune_sample
+{
+    int8_t men;
+    int8_t kings;
+    int16_t advance;
+    float result; // 1 - победа белых, 0.5 - ничья, 0 - победа чёрных
+};
+
+// Подбираемые веса. Оценка с точки зрения белых в обоих режимах оценки
+struct tuned_weights
+{
+    double queen, potential_queen, advance;
+
+    double number_eval(const tune_sample &s, const double man) const
+    {
+        return man * s.men + queen * s.kings;
+    }
+
+    double potential_eval(const tune_sample &s, const double man) const
+    {
+        return man * s.men + potential_queen * s.kings + advance * s.advance;
+    }
+};
+
+double sigmoid(const double k, const double eval)
+{
+    return 1 / (1 + exp(-k * eval));
+}
+
+// собирает тихие позиции партий бота; партии делятся между потоками
+vector<tune_sample> collect(const int games, const int level, const int threads)
+{
+    Config config;
+    config.set("Bot", "BotThreads", 1);
+    config.set("Bot", "BotPonder", false);
+    config.set("Bot", "OpeningBook", string(""));
+    config.set("Bot", "BotDelayMS", 0);
+    const int max_turns = config("Game", "MaxNumTurns");
+
+    vector<tune_sample> res;
+    mutex res_mutex;
+    atomic<int> next_game{0}, done{0};
+    auto worker = [&] {
+        Logic bot(&config);
+        bot.Max_depth = level;
+        Match match(&bot, &bot, max_turns);
+        vector<tune_sample> local;
+        for (int game = next_game++; game < games; game = next_game++)
+        {
+            // случайный дебют: свой для каждой партии и тот же при повторном запуске
+            mt19937 rng(static_cast<unsigned>(game));
+            Position pos = start_position();
+            bool color = 0;
+            int plies = 0;
+            for (; plies < OPENING_PLIES; ++plies, color = !color)
+            {
+                move_list turns;
+                gen_turns(pos, color, turns);
+                if (turns.empty())
+                    break;
+                pos = make_turn(pos, turns[rng() % turns.size()]);
+            }
+            if (plies < OPENING_PLIES)
+                continue;
+            const int res_code = match.play(pos, color);
+            const float result = (res_code == 0 ? 0.5f : (res_code == 1 ? 1.0f : 0.0f));
+            for (size_t i = 0; i < match.history.size(); ++i)
+            {
+                const Position &p = match.history[i];
+                const bool side = (color != (i % 2 == 1));
+                if (has_beats(p, side))
+                    continue; // оценка считается только в тихих позициях
+                local.push_back({int8_t(p.men_count[0] - p.men_count[1]), int8_t(p.king_count[0] - p.king_count[1]),
+                                 int16_t(p.advance[0] - p.advance[1]), result});
+            }
+            if (++done % 100 == 0)
+            {
+                printf("games %d\n", done.load());
+                fflush(stdout);
+            }
+        }
+        lock_guard<mutex> lock(res_mutex);
+        res.insert(res.end(), local.begin(), local.end());
+    };
+    vector<thread> workers;
+    for (int i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers)
+        w.join();
+    return res;
+}
+
+// Среднеквадратичная ошибка предсказания обоих режимов оценки и её градиент по весам.
+// Позиции делятся между потоками, суммы потоков складываются
+struct loss_grad
+{
+    double number_loss = 0, potential_loss = 0;
+    double d_queen = 0, d_potential_queen = 0, d_advance = 0;
+};
+
+loss_grad evaluate(const vector<tune_sample> &samples, const tuned_weights &w, const double man, const double k,
+                   const int threads)
+{
+    vector<loss_grad> parts(static_cast<size_t>(threads));
+    auto part = [&](const int id) {
+        loss_grad &g = parts[size_t(id)];
+        for (size_t i = size_t(id); i < samples.size(); i += size_t(threads))
+        {
+            const tune_sample &s = samples[i];
+            const double pn = sigmoid(k, w.number_eval(s, man)), pp = sigmoid(k, w.potential_eval(s, man));
+            const double en = pn - s.result, ep = pp - s.result;
+            g.number_loss += en * en;
+            g.potential_loss += ep * ep;
+            // d(e^2)/dw = 2 e * k p (1 - p) * признак
+            const double cn = 2 * en * k * pn * (1 - pn), cp = 2 * ep * k * pp * (1 - pp);
+            g.d_queen += cn * s.kings;
+            g.d_potential_queen += cp * s.kings;
+            g.d_advance += cp * s.advance;
+        }
+    };
+    vector<thread> workers;
+    for (int id = 1; id < threads; ++id)
+        workers.emplace_back(part, id);
+    part(0);
+    for (auto &t : workers)
+        t.join();
+    loss_grad total;
+    for (const auto &g : parts)
+    {
+        total.number_loss += g.number_loss;
+        total.potential_loss += g.potential_loss;
+        total.d_queen += g.d_queen;
+        total.d_potential_queen += g.d_potential_queen;
+        total.d_advance += g.d_advance;
+    }
+    const double n = double(max<size_t>(1, samples.size()));
+    total.number_loss /= n;
+    total.potential_loss /= n;
+    total.d_queen /= n;
+    total.d_potential_queen /= n;
+    total.d_advance /= n;
+    return total;
+}
+
+int main(int argc, char *argv[])
+{
+    const int games = (argc > 1 ? atoi(argv[1]) : 1000);
+    const int level = (argc > 2 ? atoi(argv[2]) : 4);
+    int threads = (argc > 3 ? atoi(argv[3]) : 0);
+    if (threads <= 0)
+        threads = max(1, int(thread::hardware_concurrency()));
+    const int iterations = (argc > 4 ? atoi(argv[4]) : 2000);
+    const string path = (argc > 5 ? argv[5] : "weights_tuned.json");
+
+    Config config;
+    const string current_path = config("Bot", "EvalWeights");
+    const eval_weights start = (current_path.empty() ? eval_weights() : load_eval_weights(project_path + current_path));
+    printf("level %d, %d games on %d threads\n", level, games, threads);
+    const auto collect_start = chrono::steady_clock::now();
+    const vector<tune_sample> samples = collect(games, level, threads);
+    const double collect_sec = chrono::duration<double>(chrono::steady_clock::now() - collect_start).count();
+    printf("%zu quiet positions in %.1f s\n", samples.size(), collect_sec);
+    if (samples.empty())
+        return 1;
+
+    const double man = start.man;
+    tuned_weights w{double(start.queen), double(start.potential_queen), double(start.advance)};
+    // масштаб сигмоиды: при исходных весах ошибка минимальна (поиск золотым сечением)
+    auto k_loss = [&](const double k) { return evaluate(samples, w, man, k, threads).potential_loss; };
+    double lo = 1e-4, hi = 0.1;
+    const double phi = (sqrt(5.0) - 1) / 2;
+    for (int i = 0; i < 40; ++i)
+    {
+        const double a = hi - phi * (hi - lo), b = lo + phi * (hi - lo);
+        if (k_loss(a) < k_loss(b))
+            hi = b;
+        else
+            lo = a;
+    }
+    const double k = (lo + hi) / 2;
+    const loss_grad before = evaluate(samples, w, man, k, threads);
+    printf("k %.5f, loss NumberOnly %.6f, NumberAndPotential %.6f\n", k, before.number_loss, before.potential_loss);
+
+    // Adam по трём весам
+    double m[3] = {0, 0, 0}, v[3] = {0, 0, 0};
+    const double beta1 = 0.9, beta2 = 0.999, eps = 1e-12;
+    double *params[3] = {&w.queen, &w.potential_queen, &w.advance};
+    for (int it = 1; it <= iterations; ++it)
+    {
+        const loss_grad g = evaluate(samples, w, man, k, threads);
+        const double grad[3] = {g.d_queen, g.d_potential_queen, g.d_advance};
+        for (int i = 0; i < 3; ++i)
+        {
+            m[i] = beta1 * m[i] + (1 - beta1) * grad[i];
+            v[i] = beta2 * v[i] + (1 - beta2) * grad[i] * grad[i];
+            const double m_hat = m[i] / (1 - pow(beta1, it)), v_hat = v[i] / (1 - pow(beta2, it));
+            *params[i] -= LEARNING_RATE * m_hat / (sqrt(v_hat) + eps);
+        }
+        if (it % 100 == 0 || it == iterations)
+        {
+            printf("iteration %d: loss %.6f %.6f, queen %.1f, potential queen %.1f, advance %.2f\n", it, g.number_loss,
+                   g.potential_loss, w.queen, w.potential_queen, w.advance);
+            fflush(stdout);
+        }
+    }
+
+    eval_weights tuned = start;
+    tuned.queen = int(lround(w.queen));
+    tuned.potential_queen = int(lround(w.potential_queen));
+    tuned.advance = int(lround(w.advance));
+    if (!save_eval_weights(project_path + path, tuned))
+    {
+        printf("can't write %s\n", path.c_str());
+        return 1;
+    }
+    printf("saved %s: man %d, queen %d, potential queen %d, advance %d\n", path.c_str(), tuned.man, tuned.queen,
+           tuned.potential_queen, tuned.advance);
+    return 0;
+}